@@ -0,0 +1,217 @@
+#include <tchar.h>
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "Logger.h"
+
+using namespace Utils;
+
+namespace {
+	using SteadyClock = std::chrono::steady_clock;
+
+	/// <summary>
+	/// 参与比较的日志配置
+	/// </summary>
+	enum class Mode {
+		SYNC,
+		SYNC_MAPPED,
+		ASYNC,
+		ASYNC_MAPPED,
+		BINARY,
+	};
+
+	constexpr Mode ALL_MODES[] = { Mode::SYNC, Mode::SYNC_MAPPED, Mode::ASYNC, Mode::ASYNC_MAPPED, Mode::BINARY };
+
+	const char* GetModeName(Mode p_mode) {
+		switch (p_mode) {
+			case Mode::SYNC:
+				return "sync";
+			case Mode::SYNC_MAPPED:
+				return "sync+mapped";
+			case Mode::ASYNC:
+				return "async";
+			case Mode::ASYNC_MAPPED:
+				return "async+mapped";
+			case Mode::BINARY:
+				return "binary";
+		}
+		return "";
+	}
+
+	struct Options {
+		size_t nMaxThreads = std::max(1u, std::thread::hardware_concurrency());
+		size_t nMessages   = 100'000;
+		std::vector<size_t> vnSizes { 16, 128, 1024 };
+	};
+
+	struct Result {
+		double dLinesPerSec;
+		double dBytesPerSec;
+		double dP50;
+		double dP99;
+		double dP999;
+	};
+
+	double Percentile(const std::vector<int64_t>& pc_vnSorted, double p_dRatio) {
+		if (pc_vnSorted.empty()) {
+			return 0;
+		}
+		const size_t idx = std::min(pc_vnSorted.size() - 1, static_cast<size_t>(p_dRatio * pc_vnSorted.size()));
+		return static_cast<double>(pc_vnSorted[idx]);
+	}
+
+	uintmax_t GetDirectorySize(const std::filesystem::path& pc_path) {
+		uintmax_t nTotal = 0;
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(pc_path, ec)) {
+			nTotal += entry.file_size(ec);
+		}
+		return nTotal;
+	}
+
+	/// <summary>
+	/// 以给定配置从多个线程同时调用 Info，记录每次调用的耗时
+	/// </summary>
+	Result Run(Mode p_mode, size_t p_nThreads, size_t p_nSize, size_t p_nMessages) {
+		const std::filesystem::path dir = std::filesystem::temp_directory_path() / TEXT("UtilsLogBench");
+		std::error_code ec;
+		std::filesystem::remove_all(dir, ec);
+		std::filesystem::create_directories(dir, ec);
+
+		const size_t nPerThread = std::max<size_t>(1, p_nMessages / p_nThreads);
+		std::vector<std::vector<int64_t>> vvnLatencies(p_nThreads, std::vector<int64_t>(nPerThread));
+		double dSeconds;
+
+		{
+			Logger logger(TEXT("bench"), dir.native(), LogLevel::INFO);
+			logger.MappedFile = p_mode == Mode::SYNC_MAPPED || p_mode == Mode::ASYNC_MAPPED;
+			logger.BinaryMode = p_mode == Mode::BINARY;
+			if (p_mode == Mode::ASYNC || p_mode == Mode::ASYNC_MAPPED) {
+				logger.EnableAsync(65536);
+			}
+
+			const String strPayload(p_nSize, TEXT('x'));
+			std::barrier barStart(static_cast<std::ptrdiff_t>(p_nThreads + 1));
+
+			std::vector<std::thread> vThreads;
+			for (size_t idxThread = 0; idxThread < p_nThreads; ++idxThread) {
+				vThreads.emplace_back([&, idxThread]() {
+					std::vector<int64_t>& vnLatencies = vvnLatencies[idxThread];
+					barStart.arrive_and_wait();
+					for (size_t idx = 0; idx < nPerThread; ++idx) {
+						const auto tpBegin = SteadyClock::now();
+						if (p_mode == Mode::BINARY) {
+							logger.InfoB("{} {}", idx, strPayload);
+						} else {
+							logger.InfoF("{} {}", idx, strPayload);
+						}
+						vnLatencies[idx] = std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - tpBegin).count();
+					}
+				});
+			}
+
+			barStart.arrive_and_wait();
+			const auto tpBegin = SteadyClock::now();
+			for (auto& thread : vThreads) {
+				thread.join();
+			}
+			logger.Flush();
+			dSeconds = std::chrono::duration<double>(SteadyClock::now() - tpBegin).count();
+		}
+
+		std::vector<int64_t> vnAll;
+		vnAll.reserve(nPerThread * p_nThreads);
+		for (const auto& vnLatencies : vvnLatencies) {
+			vnAll.insert(vnAll.end(), vnLatencies.begin(), vnLatencies.end());
+		}
+		std::sort(vnAll.begin(), vnAll.end());
+
+		const double dLines = static_cast<double>(vnAll.size());
+		const double dBytes = static_cast<double>(GetDirectorySize(dir));
+		std::filesystem::remove_all(dir, ec);
+
+		return { dLines / dSeconds, dBytes / dSeconds, Percentile(vnAll, 0.5), Percentile(vnAll, 0.99), Percentile(vnAll, 0.999) };
+	}
+
+	/// <summary>
+	/// 测量被级别过滤的 Debug 调用的开销
+	/// </summary>
+	double MeasureDisabledDebug(size_t p_nMessages) {
+		Logger logger(TEXT("bench"), std::filesystem::temp_directory_path().native(), LogLevel::INFO);
+
+		const auto tpBegin = SteadyClock::now();
+		for (size_t idx = 0; idx < p_nMessages; ++idx) {
+			logger.Debug(TEXT(__FUNCTION__), TEXT("{} {}"), idx, 3.14);
+		}
+		return std::chrono::duration<double, std::nano>(SteadyClock::now() - tpBegin).count() / p_nMessages;
+	}
+
+	/// <summary>
+	/// 测量连续记录时格式化时间戳前缀与整行的开销
+	/// </summary>
+	double MeasureFormatLine(size_t p_nMessages) {
+		String strLine;
+		const auto tpBegin = SteadyClock::now();
+		for (size_t idx = 0; idx < p_nMessages; ++idx) {
+			strLine.clear();
+			Logger::FormatLine(strLine, DateTimeUtils::Now(), LogLevel::INFO, TEXT(__FUNCTION__), TEXT("message"));
+		}
+		return std::chrono::duration<double, std::nano>(SteadyClock::now() - tpBegin).count() / p_nMessages;
+	}
+
+	bool ParseOptions(int argc, TCHAR* argv[], Options& p_options) {
+		for (int idx = 1; idx + 1 < argc; idx += 2) {
+			const StringView svName = argv[idx];
+			const size_t nValue     = static_cast<size_t>(std::stoull(argv[idx + 1]));
+			if (svName == TEXT("--threads")) {
+				p_options.nMaxThreads = std::max<size_t>(1, nValue);
+			} else if (svName == TEXT("--messages")) {
+				p_options.nMessages = std::max<size_t>(1, nValue);
+			} else if (svName == TEXT("--size")) {
+				p_options.vnSizes = { nValue };
+			} else {
+				return false;
+			}
+		}
+		return argc % 2 == 1;
+	}
+}
+
+/// <summary>
+/// Logger 的吞吐量与单次调用延迟测试，比较同步、异步、内存映射与二进制模式
+/// <para>用法：LogBench [--threads 最大线程数] [--messages 每轮记录数] [--size 消息长度]</para>
+/// </summary>
+int _tmain(int argc, TCHAR* argv[]) {
+	Options options;
+	try {
+		if (!ParseOptions(argc, argv, options)) {
+			std::cerr << "usage: LogBench [--threads N] [--messages N] [--size N]" << std::endl;
+			return 1;
+		}
+	} catch (const std::exception&) {
+		std::cerr << "usage: LogBench [--threads N] [--messages N] [--size N]" << std::endl;
+		return 1;
+	}
+
+	std::cout << std::format("FormatLine: {:.1f} ns/line\n", MeasureFormatLine(options.nMessages));
+	std::cout << std::format("disabled Debug: {:.1f} ns/call\n\n", MeasureDisabledDebug(options.nMessages));
+
+	std::cout << std::format("{:<14}{:>8}{:>8}{:>14}{:>12}{:>10}{:>10}{:>10}\n", "mode", "threads", "size", "lines/s", "MB/s", "p50 ns", "p99 ns",
+	    "p99.9 ns");
+	for (const Mode mode : ALL_MODES) {
+		for (const size_t nSize : options.vnSizes) {
+			for (size_t nThreads = 1; nThreads <= options.nMaxThreads; nThreads *= 2) {
+				const Result result = Run(mode, nThreads, nSize, options.nMessages);
+				std::cout << std::format("{:<14}{:>8}{:>8}{:>14.0f}{:>12.1f}{:>10.0f}{:>10.0f}{:>10.0f}\n", GetModeName(mode), nThreads, nSize,
+				    result.dLinesPerSec, result.dBytesPerSec / (1024 * 1024), result.dP50, result.dP99, result.dP999);
+			}
+		}
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+#include "Compression.h"
+
+#include <cstring>
+#include <fstream>
+
+_UTILS_BEGIN
+
+namespace {
+	constexpr size_t MIN_MATCH      = 4;
+	constexpr size_t LAST_LITERALS  = 5;
+	constexpr size_t MATCH_LIMIT    = 12;
+	constexpr size_t MAX_DISTANCE   = 65535;
+	constexpr int HASH_LOG          = 14;
+	constexpr size_t FILE_BLOCK     = 4 * 1024 * 1024;
+	constexpr uint32_t STORED_FLAG  = 0x8000'0000;
+	constexpr char FILE_MAGIC[4]    = { 'U', 'L', 'Z', '1' };
+
+	inline uint32_t Read32(const byte* p_pData) {
+		uint32_t nValue;
+		std::memcpy(&nValue, p_pData, sizeof(nValue));
+		return nValue;
+	}
+
+	inline uint32_t Hash(uint32_t p_nValue) {
+		return (p_nValue * 2654435761u) >> (32 - HASH_LOG);
+	}
+
+	inline void WriteLength(std::vector<byte>& p_vbOut, size_t p_nLen) {
+		for (; p_nLen >= 255; p_nLen -= 255) {
+			p_vbOut.push_back(255);
+		}
+		p_vbOut.push_back(static_cast<byte>(p_nLen));
+	}
+
+	void WriteSequence(std::vector<byte>& p_vbOut, const byte* p_pLiterals, size_t p_nLiteralLen, size_t p_nOffset, size_t p_nMatchLen) {
+		const size_t nMatchCode = p_nMatchLen ? p_nMatchLen - MIN_MATCH : 0;
+		p_vbOut.push_back(static_cast<byte>((std::min<size_t>(p_nLiteralLen, 15) << 4) | std::min<size_t>(nMatchCode, 15)));
+		if (p_nLiteralLen >= 15) {
+			WriteLength(p_vbOut, p_nLiteralLen - 15);
+		}
+		p_vbOut.insert(p_vbOut.end(), p_pLiterals, p_pLiterals + p_nLiteralLen);
+
+		if (!p_nMatchLen) {
+			return;
+		}
+
+		p_vbOut.push_back(static_cast<byte>(p_nOffset & 0xFF));
+		p_vbOut.push_back(static_cast<byte>(p_nOffset >> 8));
+		if (nMatchCode >= 15) {
+			WriteLength(p_vbOut, nMatchCode - 15);
+		}
+	}
+
+	inline size_t ReadLength(const byte*& p_pIn, const byte* p_pEnd, size_t p_nLen) {
+		if (p_nLen != 15) {
+			return p_nLen;
+		}
+
+		byte bValue;
+		do {
+			if (p_pIn >= p_pEnd) {
+				throw InvalidArgumentException(TEXT("压缩数据已损坏"));
+			}
+			bValue = *p_pIn++;
+			p_nLen += bValue;
+		} while (bValue == 255);
+		return p_nLen;
+	}
+}
+
+std::vector<byte> CompressionUtils::Compress(const byte* p_pData, size_t p_nSize) {
+	std::vector<byte> vbOut;
+	vbOut.reserve(p_nSize + p_nSize / 255 + 16);
+
+	size_t nAnchor = 0;
+	if (p_nSize > MATCH_LIMIT) {
+		std::vector<uint32_t> vnTable(size_t(1) << HASH_LOG, 0);
+		const size_t nMatchStartLimit = p_nSize - MATCH_LIMIT;
+		const size_t nMatchEndLimit   = p_nSize - LAST_LITERALS;
+
+		size_t nPos = 0;
+		while (nPos < nMatchStartLimit) {
+			const uint32_t nSeq  = Read32(p_pData + nPos);
+			const uint32_t nHash = Hash(nSeq);
+			const size_t nRef    = vnTable[nHash];
+			vnTable[nHash]       = static_cast<uint32_t>(nPos);
+
+			if (nRef >= nPos || nPos - nRef > MAX_DISTANCE || Read32(p_pData + nRef) != nSeq) {
+				++nPos;
+				continue;
+			}
+
+			size_t nLen = MIN_MATCH;
+			while (nPos + nLen < nMatchEndLimit && p_pData[nRef + nLen] == p_pData[nPos + nLen]) {
+				++nLen;
+			}
+
+			WriteSequence(vbOut, p_pData + nAnchor, nPos - nAnchor, nPos - nRef, nLen);
+			nPos += nLen;
+			nAnchor = nPos;
+		}
+	}
+
+	WriteSequence(vbOut, p_pData + nAnchor, p_nSize - nAnchor, 0, 0);
+	return vbOut;
+}
+
+std::vector<byte> CompressionUtils::Decompress(const byte* p_pData, size_t p_nSize, size_t p_nRawSize) {
+	std::vector<byte> vbOut;
+	vbOut.reserve(p_nRawSize);
+
+	const byte* pIn  = p_pData;
+	const byte* pEnd = p_pData + p_nSize;
+	while (pIn < pEnd) {
+		const byte bToken = *pIn++;
+
+		const size_t nLiteralLen = ReadLength(pIn, pEnd, bToken >> 4);
+		if (static_cast<size_t>(pEnd - pIn) < nLiteralLen || vbOut.size() + nLiteralLen > p_nRawSize) {
+			throw InvalidArgumentException(TEXT("压缩数据已损坏"));
+		}
+		vbOut.insert(vbOut.end(), pIn, pIn + nLiteralLen);
+		pIn += nLiteralLen;
+
+		if (pIn == pEnd) {
+			break; // 最后一个序列只有字面量
+		}
+
+		if (pEnd - pIn < 2) {
+			throw InvalidArgumentException(TEXT("压缩数据已损坏"));
+		}
+		const size_t nOffset = pIn[0] | (pIn[1] << 8);
+		pIn += 2;
+
+		const size_t nMatchLen = ReadLength(pIn, pEnd, bToken & 0x0F) + MIN_MATCH;
+		if (nOffset == 0 || nOffset > vbOut.size() || vbOut.size() + nMatchLen > p_nRawSize) {
+			throw InvalidArgumentException(TEXT("压缩数据已损坏"));
+		}
+
+		// 匹配区可能与输出重叠，需逐字节复制
+		size_t nSrc = vbOut.size() - nOffset;
+		for (size_t idx = 0; idx < nMatchLen; ++idx) {
+			vbOut.push_back(vbOut[nSrc + idx]);
+		}
+	}
+
+	if (vbOut.size() != p_nRawSize) {
+		throw InvalidArgumentException(TEXT("压缩数据已损坏"));
+	}
+	return vbOut;
+}
+
+bool CompressionUtils::CompressFile(const String& pc_strSrcPath, const String& pc_strDstPath) {
+	std::ifstream ifs(pc_strSrcPath, std::ios::binary);
+	std::ofstream ofs(pc_strDstPath, std::ios::binary | std::ios::trunc);
+	if (!ifs.is_open() || !ofs.is_open()) {
+		return false;
+	}
+
+	ofs.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+
+	std::vector<byte> vbBlock(FILE_BLOCK);
+	while (ifs) {
+		ifs.read(reinterpret_cast<char*>(vbBlock.data()), vbBlock.size());
+		const uint32_t nRawSize = static_cast<uint32_t>(ifs.gcount());
+		if (nRawSize == 0) {
+			break;
+		}
+
+		const std::vector<byte> vbPacked = Compress(vbBlock.data(), nRawSize);
+		const bool bStored               = vbPacked.size() >= nRawSize;
+		const uint32_t nPackedSize       = bStored ? (nRawSize | STORED_FLAG) : static_cast<uint32_t>(vbPacked.size());
+
+		ofs.write(reinterpret_cast<const char*>(&nRawSize), sizeof(nRawSize));
+		ofs.write(reinterpret_cast<const char*>(&nPackedSize), sizeof(nPackedSize));
+		if (bStored) {
+			ofs.write(reinterpret_cast<const char*>(vbBlock.data()), nRawSize);
+		} else {
+			ofs.write(reinterpret_cast<const char*>(vbPacked.data()), vbPacked.size());
+		}
+	}
+
+	ofs.close();
+	return !ofs.fail();
+}
+
+bool CompressionUtils::DecompressFile(const String& pc_strSrcPath, const String& pc_strDstPath) {
+	std::ifstream ifs(pc_strSrcPath, std::ios::binary);
+	if (!ifs.is_open()) {
+		return false;
+	}
+
+	char szMagic[sizeof(FILE_MAGIC)] = {};
+	ifs.read(szMagic, sizeof(szMagic));
+	if (ifs.gcount() != sizeof(szMagic) || std::memcmp(szMagic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+		throw InvalidArgumentException(pc_strSrcPath.c_str());
+	}
+
+	std::ofstream ofs(pc_strDstPath, std::ios::binary | std::ios::trunc);
+	if (!ofs.is_open()) {
+		return false;
+	}
+
+	std::vector<byte> vbPacked;
+	uint32_t nRawSize, nPackedSize;
+	while (ifs.read(reinterpret_cast<char*>(&nRawSize), sizeof(nRawSize)) && ifs.read(reinterpret_cast<char*>(&nPackedSize), sizeof(nPackedSize))) {
+		const bool bStored = (nPackedSize & STORED_FLAG) != 0;
+		nPackedSize &= ~STORED_FLAG;
+		if (nRawSize > FILE_BLOCK || nPackedSize > FILE_BLOCK + FILE_BLOCK / 255 + 16) {
+			throw InvalidArgumentException(pc_strSrcPath.c_str());
+		}
+
+		vbPacked.resize(nPackedSize);
+		if (!ifs.read(reinterpret_cast<char*>(vbPacked.data()), nPackedSize)) {
+			throw InvalidArgumentException(pc_strSrcPath.c_str());
+		}
+
+		if (bStored) {
+			ofs.write(reinterpret_cast<const char*>(vbPacked.data()), nPackedSize);
+		} else {
+			const std::vector<byte> vbRaw = Decompress(vbPacked.data(), nPackedSize, nRawSize);
+			ofs.write(reinterpret_cast<const char*>(vbRaw.data()), vbRaw.size());
+		}
+	}
+
+	ofs.close();
+	return !ofs.fail();
+}
+
+_UTILS_END
\ No newline at end of file
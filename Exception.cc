@@ -38,7 +38,8 @@ UTILS_API const TCHAR* ConcatBaseErrorMessage(long p_lBaseErrCode, const TCHAR*
 	}
 
 	if (p_cwszMsg) {
-		g_strFinalMessage += StringUtils::Trim(p_cwszMsg, { String(TEXT("。")) }) + TEXT("！");
+		g_strFinalMessage += StringUtils::TrimView(p_cwszMsg, { TEXT("。") });
+		g_strFinalMessage += TEXT("！");
 	}
 
 	return g_strFinalMessage.c_str();
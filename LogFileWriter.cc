@@ -0,0 +1,274 @@
+#include "LogFileWriter.h"
+
+#include <algorithm>
+#include <cstring>
+
+_UTILS_BEGIN
+
+namespace {
+	/// <summary>
+	/// 打开日志文件用于追加，文件不存在时创建，允许其他进程同时读取
+	/// </summary>
+	HANDLE OpenForAppend(const String& pc_strPath, DWORD p_dwAccess) {
+		return ::CreateFile(pc_strPath.c_str(), p_dwAccess, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_ALWAYS,
+		    FILE_ATTRIBUTE_NORMAL, NULL);
+	}
+}
+
+BufferedLogFileWriter::~BufferedLogFileWriter() {
+	this->Close();
+}
+
+bool BufferedLogFileWriter::Open(const String& pc_strPath, bool p_bBinary) {
+	this->Close();
+
+	m_hFile_ = OpenForAppend(pc_strPath, GENERIC_WRITE);
+	if (m_hFile_ == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER liSize {};
+	if (!::GetFileSizeEx(m_hFile_, &liSize)) {
+		this->Close();
+		return false;
+	}
+
+	m_nSize_   = static_cast<size_t>(liSize.QuadPart);
+	m_bBinary_ = p_bBinary;
+	m_strBuffer_.reserve(BUFFER_SIZE);
+	return true;
+}
+
+void BufferedLogFileWriter::Close() {
+	if (m_hFile_ == INVALID_HANDLE_VALUE) {
+		return;
+	}
+
+	this->Flush();
+	::CloseHandle(m_hFile_);
+	m_hFile_ = INVALID_HANDLE_VALUE;
+	m_nSize_ = 0;
+}
+
+bool BufferedLogFileWriter::Write(const char* p_pData, size_t p_nSize) {
+	if (m_hFile_ == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	const size_t nOldSize = m_strBuffer_.size();
+	if (m_bBinary_) {
+		m_strBuffer_.append(p_pData, p_nSize);
+	} else {
+		// 文本模式下将'\n'写为"\r\n"
+		const char* pEnd = p_pData + p_nSize;
+		for (const char* pBegin = p_pData; pBegin < pEnd;) {
+			const char* pLine = std::find(pBegin, pEnd, '\n');
+			m_strBuffer_.append(pBegin, pLine);
+			if (pLine == pEnd) {
+				break;
+			}
+			m_strBuffer_.append("\r\n", 2);
+			pBegin = pLine + 1;
+		}
+	}
+	m_nSize_ += m_strBuffer_.size() - nOldSize;
+
+	if (m_strBuffer_.size() >= BUFFER_SIZE) {
+		this->Flush();
+	}
+	return true;
+}
+
+void BufferedLogFileWriter::Flush() {
+	if (m_hFile_ == INVALID_HANDLE_VALUE || m_strBuffer_.empty()) {
+		return;
+	}
+
+	// 偏移量全为 0xFFFFFFFF 时写入文件末尾，多个进程同时追加同一文件时也不会相互覆盖
+	const char* pData = m_strBuffer_.data();
+	size_t nRemain    = m_strBuffer_.size();
+	while (nRemain > 0) {
+		OVERLAPPED overlapped {};
+		overlapped.Offset     = 0xFFFF'FFFF;
+		overlapped.OffsetHigh = 0xFFFF'FFFF;
+
+		DWORD dwWritten = 0;
+		const DWORD dwSize = static_cast<DWORD>(std::min<size_t>(nRemain, MAXDWORD));
+		if (!::WriteFile(m_hFile_, pData, dwSize, &dwWritten, &overlapped) || dwWritten == 0) {
+			break;
+		}
+		pData += dwWritten;
+		nRemain -= dwWritten;
+	}
+	m_strBuffer_.clear();
+}
+
+bool BufferedLogFileWriter::Sync() {
+	if (m_hFile_ == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	this->Flush();
+	return ::FlushFileBuffers(m_hFile_) != FALSE;
+}
+
+MappedLogFileWriter::MappedLogFileWriter(size_t p_nChunkSize, ValidLengthFn p_fnValidLength)
+    : m_nChunkSize_(p_nChunkSize == 0 ? DEFAULT_CHUNK_SIZE : p_nChunkSize)
+    , m_fnValidLength_(p_fnValidLength) {
+}
+
+MappedLogFileWriter::~MappedLogFileWriter() {
+	this->Close();
+}
+
+bool MappedLogFileWriter::Map_(size_t p_nCapacity) {
+	const uint64_t nCapacity = p_nCapacity;
+
+	// 映射大小超过文件长度时，系统会将文件扩展到该长度
+	m_hMapping_ = ::CreateFileMapping(
+	    m_hFile_, NULL, PAGE_READWRITE, static_cast<DWORD>(nCapacity >> 32), static_cast<DWORD>(nCapacity & 0xFFFF'FFFF), NULL);
+	if (m_hMapping_ == NULL) {
+		return false;
+	}
+
+	m_pView_ = static_cast<char*>(::MapViewOfFile(m_hMapping_, FILE_MAP_WRITE, 0, 0, p_nCapacity));
+	if (m_pView_ == nullptr) {
+		this->Unmap_();
+		return false;
+	}
+
+	m_nCapacity_ = p_nCapacity;
+	return true;
+}
+
+void MappedLogFileWriter::Unmap_() noexcept {
+	if (m_pView_) {
+		::UnmapViewOfFile(m_pView_);
+		m_pView_ = nullptr;
+	}
+	if (m_hMapping_ != NULL) {
+		::CloseHandle(m_hMapping_);
+		m_hMapping_ = NULL;
+	}
+	m_nCapacity_ = 0;
+}
+
+bool MappedLogFileWriter::Open(const String& pc_strPath, bool p_bBinary) {
+	this->Close();
+
+	m_hFile_ = OpenForAppend(pc_strPath, GENERIC_READ | GENERIC_WRITE);
+	if (m_hFile_ == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER liSize {};
+	if (!::GetFileSizeEx(m_hFile_, &liSize)) {
+		this->Close();
+		return false;
+	}
+	m_nSize_   = static_cast<size_t>(liSize.QuadPart);
+	m_bBinary_ = p_bBinary;
+
+	// 上次未正常关闭时，文件末尾残留着预分配的空白，否则新的记录会追加在空白之后，且空白会计入文件大小
+	if (m_nSize_ > 0) {
+		if (!this->Map_(m_nSize_)) {
+			this->Close();
+			return false;
+		}
+		if (m_pView_[m_nSize_ - 1] == '\0') {
+			if (p_bBinary && m_fnValidLength_) {
+				m_nSize_ = std::min(m_fnValidLength_(m_pView_, m_nSize_), m_nSize_);
+			} else {
+				// 文本中不会出现'\0'，可以安全地去掉
+				while (m_nSize_ > 0 && m_pView_[m_nSize_ - 1] == '\0') {
+					--m_nSize_;
+				}
+			}
+		}
+	}
+
+	const size_t nCapacity = (m_nSize_ / m_nChunkSize_ + 1) * m_nChunkSize_;
+	if (nCapacity != m_nCapacity_) {
+		this->Unmap_();
+		if (!this->Map_(nCapacity)) {
+			this->Close();
+			return false;
+		}
+	}
+	return true;
+}
+
+void MappedLogFileWriter::Close() {
+	if (m_hFile_ == INVALID_HANDLE_VALUE) {
+		return;
+	}
+
+	this->Unmap_();
+
+	// 截掉预分配但未使用的部分
+	LARGE_INTEGER liSize {};
+	liSize.QuadPart = static_cast<LONGLONG>(m_nSize_);
+	if (::SetFilePointerEx(m_hFile_, liSize, NULL, FILE_BEGIN)) {
+		::SetEndOfFile(m_hFile_);
+	}
+
+	::CloseHandle(m_hFile_);
+	m_hFile_ = INVALID_HANDLE_VALUE;
+	m_nSize_ = 0;
+}
+
+bool MappedLogFileWriter::Write(const char* p_pData, size_t p_nSize) {
+	if (m_hFile_ == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	// 文本模式下将'\n'写为"\r\n"
+	const size_t nNewLines = m_bBinary_ ? 0 : static_cast<size_t>(std::count(p_pData, p_pData + p_nSize, '\n'));
+	const size_t nRequired = m_nSize_ + p_nSize + nNewLines;
+	if (nRequired > m_nCapacity_) {
+		const size_t nCapacity = (nRequired / m_nChunkSize_ + 1) * m_nChunkSize_;
+		this->Unmap_();
+		if (!this->Map_(nCapacity)) {
+			return false;
+		}
+	}
+
+	if (nNewLines == 0) {
+		std::memcpy(m_pView_ + m_nSize_, p_pData, p_nSize);
+		m_nSize_ += p_nSize;
+		return true;
+	}
+
+	const char* pEnd = p_pData + p_nSize;
+	for (const char* pBegin = p_pData; pBegin < pEnd;) {
+		const char* pLine  = std::find(pBegin, pEnd, '\n');
+		const size_t nSize = static_cast<size_t>(pLine - pBegin);
+		std::memcpy(m_pView_ + m_nSize_, pBegin, nSize);
+		m_nSize_ += nSize;
+		if (pLine == pEnd) {
+			break;
+		}
+		m_pView_[m_nSize_++] = '\r';
+		m_pView_[m_nSize_++] = '\n';
+		pBegin               = pLine + 1;
+	}
+	return true;
+}
+
+void MappedLogFileWriter::Flush() {
+	// 映射视图与文件缓存一致，其他进程读取时已可见，无需额外操作
+}
+
+bool MappedLogFileWriter::Sync() {
+	if (m_hFile_ == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	// 先将映射视图中的脏页写入文件，再等待文件数据落盘
+	if (m_pView_ && m_nSize_ > 0 && !::FlushViewOfFile(m_pView_, m_nSize_)) {
+		return false;
+	}
+	return ::FlushFileBuffers(m_hFile_) != FALSE;
+}
+
+_UTILS_END
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include "LogFlightRecorder.h"
+
+#include <algorithm>
+#include <bit>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
+
+_UTILS_BEGIN
+
+namespace {
+	/// <summary>
+	/// 所有存活的飞行记录器组成的单向链表，登记与注销由 g_mtxRecorders 串行化；崩溃时不加锁，只按 acquire 顺序遍历
+	/// </summary>
+	std::atomic<LogFlightRecorder*> g_pRecorders { nullptr };
+	std::mutex g_mtxRecorders;
+	std::atomic_flag g_bDumping = ATOMIC_FLAG_INIT;
+
+	/// <summary>
+	/// 第一个记录器登记时安装的处理函数替换下来的原处理函数，最后一个记录器注销时恢复
+	/// </summary>
+	std::terminate_handler g_fnPrevTerminate             = nullptr;
+	LPTOP_LEVEL_EXCEPTION_FILTER g_fnPrevExceptionFilter = nullptr;
+	void (*g_fnPrevAbort)(int)                           = SIG_DFL;
+
+	/// <summary>
+	/// 每个进程只转储一次，避免转储过程中再次崩溃时重入
+	/// </summary>
+	void DumpOnce() noexcept {
+		if (!g_bDumping.test_and_set()) {
+			LogFlightRecorder::DumpAll();
+		}
+	}
+
+	void OnTerminate() {
+		DumpOnce();
+		if (g_fnPrevTerminate) {
+			g_fnPrevTerminate();
+		}
+		std::abort();
+	}
+
+	void OnAbortSignal(int p_nSignal) {
+		DumpOnce();
+		if (g_fnPrevAbort != SIG_DFL && g_fnPrevAbort != SIG_IGN && g_fnPrevAbort != SIG_ERR) {
+			g_fnPrevAbort(p_nSignal);
+		}
+		std::signal(p_nSignal, SIG_DFL);
+		std::raise(p_nSignal);
+	}
+
+	LONG WINAPI OnUnhandledException(EXCEPTION_POINTERS* p_pInfo) {
+		DumpOnce();
+		return g_fnPrevExceptionFilter ? g_fnPrevExceptionFilter(p_pInfo) : EXCEPTION_CONTINUE_SEARCH;
+	}
+
+	void InstallHandlers() {
+		g_fnPrevTerminate       = std::set_terminate(&OnTerminate);
+		g_fnPrevExceptionFilter = ::SetUnhandledExceptionFilter(&OnUnhandledException);
+		g_fnPrevAbort           = std::signal(SIGABRT, &OnAbortSignal);
+	}
+
+	/// <summary>
+	/// 恢复安装前的处理函数；宿主在此之后又安装了自己的处理函数时保留宿主的
+	/// </summary>
+	void RestoreHandlers() {
+		if (std::get_terminate() == &OnTerminate) {
+			std::set_terminate(g_fnPrevTerminate);
+		}
+
+		const LPTOP_LEVEL_EXCEPTION_FILTER fnCurrentFilter = ::SetUnhandledExceptionFilter(g_fnPrevExceptionFilter);
+		if (fnCurrentFilter != &OnUnhandledException) {
+			::SetUnhandledExceptionFilter(fnCurrentFilter);
+		}
+
+		const auto fnCurrentAbort = std::signal(SIGABRT, g_fnPrevAbort == SIG_ERR ? SIG_DFL : g_fnPrevAbort);
+		if (fnCurrentAbort != &OnAbortSignal && fnCurrentAbort != SIG_ERR) {
+			std::signal(SIGABRT, fnCurrentAbort);
+		}
+	}
+
+	/// <summary>
+	/// 与 Logger 文本文件中的级别名称一致
+	/// </summary>
+	std::string_view GetPaddedLevelName(LogLevel p_level) noexcept {
+		switch (p_level) {
+			case LogLevel::TRACE:
+				return "trace";
+			case LogLevel::DEBUG:
+				return "debug";
+			case LogLevel::INFO:
+				return "info ";
+			case LogLevel::WARN:
+				return "warn ";
+			case LogLevel::ERR:
+				return "error";
+			default:
+				return "     ";
+		}
+	}
+
+	/// <summary>
+	/// 在定长缓冲中拼接一行 UTF-8 文本，不分配内存，超出容量的部分被截断
+	/// </summary>
+	class FixedLineWriter {
+	private:
+		char* m_pBegin_;
+		char* m_pCur_;
+		char* m_pEnd_;
+
+	public:
+		FixedLineWriter(char* p_pBuffer, size_t p_nCapacity) noexcept
+		    : m_pBegin_(p_pBuffer)
+		    , m_pCur_(p_pBuffer)
+		    , m_pEnd_(p_pBuffer + p_nCapacity) {
+		}
+
+		size_t GetSize() const noexcept {
+			return static_cast<size_t>(m_pCur_ - m_pBegin_);
+		}
+
+		void Append(std::string_view p_svText) noexcept {
+			const size_t nSize = std::min(p_svText.size(), static_cast<size_t>(m_pEnd_ - m_pCur_));
+			std::memcpy(m_pCur_, p_svText.data(), nSize);
+			m_pCur_ += nSize;
+		}
+
+		/// <summary>
+		/// 追加十进制数，不足 p_nWidth 位时左侧补 0
+		/// </summary>
+		void AppendNumber(uint32_t p_nValue, size_t p_nWidth) noexcept {
+			char szDigits[10];
+			size_t nDigits = 0;
+			do {
+				szDigits[nDigits++] = static_cast<char>('0' + p_nValue % 10);
+				p_nValue /= 10;
+			} while (p_nValue != 0);
+			for (; nDigits < std::min(p_nWidth, std::size(szDigits)); ++nDigits) {
+				szDigits[nDigits] = '0';
+			}
+			while (nDigits > 0 && m_pCur_ < m_pEnd_) {
+				*m_pCur_++ = szDigits[--nDigits];
+			}
+		}
+
+		/// <summary>
+		/// 追加文本，宽字符按 UTF-8 编码，放不下的字符整个丢弃
+		/// </summary>
+		void AppendText(const TCHAR* p_pText, size_t p_nLength) noexcept {
+#ifdef _UNICODE
+			for (size_t idx = 0; idx < p_nLength; ++idx) {
+				uint32_t nCode = static_cast<uint16_t>(p_pText[idx]);
+				if (nCode >= 0xD800 && nCode <= 0xDBFF && idx + 1 < p_nLength && p_pText[idx + 1] >= 0xDC00 && p_pText[idx + 1] <= 0xDFFF) {
+					nCode = 0x10000 + ((nCode - 0xD800) << 10) + (static_cast<uint16_t>(p_pText[++idx]) - 0xDC00);
+				} else if (nCode >= 0xD800 && nCode <= 0xDFFF) {
+					nCode = 0xFFFD;
+				}
+
+				char szBytes[4];
+				size_t nBytes;
+				if (nCode < 0x80) {
+					szBytes[0] = static_cast<char>(nCode);
+					nBytes     = 1;
+				} else if (nCode < 0x800) {
+					szBytes[0] = static_cast<char>(0xC0 | (nCode >> 6));
+					szBytes[1] = static_cast<char>(0x80 | (nCode & 0x3F));
+					nBytes     = 2;
+				} else if (nCode < 0x10000) {
+					szBytes[0] = static_cast<char>(0xE0 | (nCode >> 12));
+					szBytes[1] = static_cast<char>(0x80 | ((nCode >> 6) & 0x3F));
+					szBytes[2] = static_cast<char>(0x80 | (nCode & 0x3F));
+					nBytes     = 3;
+				} else {
+					szBytes[0] = static_cast<char>(0xF0 | (nCode >> 18));
+					szBytes[1] = static_cast<char>(0x80 | ((nCode >> 12) & 0x3F));
+					szBytes[2] = static_cast<char>(0x80 | ((nCode >> 6) & 0x3F));
+					szBytes[3] = static_cast<char>(0x80 | (nCode & 0x3F));
+					nBytes     = 4;
+				}
+				if (static_cast<size_t>(m_pEnd_ - m_pCur_) < nBytes) {
+					return;
+				}
+				std::memcpy(m_pCur_, szBytes, nBytes);
+				m_pCur_ += nBytes;
+			}
+#else
+			this->Append(std::string_view(p_pText, p_nLength));
+#endif // _UNICODE
+		}
+	};
+}
+
+struct LogFlightRecorder::DumpBuffer_ {
+	/// <summary>
+	/// 一行转储文本的最大字节数，足以容纳 MESSAGE_CAPACITY 个字符按 UTF-8 编码后的长度
+	/// </summary>
+	static constexpr size_t LINE_CAPACITY = 4096;
+
+	DateTime dtTime {};
+	LogLevel level = LogLevel::NONE;
+	const TCHAR* pcszFuncName = nullptr;
+	size_t nLength = 0;
+	TCHAR szMsg[MESSAGE_CAPACITY] {};
+	char szLine[LINE_CAPACITY] {};
+
+	/// <summary>
+	/// 按 Logger 文本文件的格式生成一行，只做整数运算，不使用时区数据库与格式化库
+	/// </summary>
+	size_t FormatLine() noexcept {
+		const auto dtDays   = std::chrono::floor<Days>(dtTime);
+		const auto ymd      = std::chrono::year_month_day(dtDays);
+		const auto nMillis  = std::chrono::duration_cast<MilliSeconds>(dtTime - dtDays).count();
+		const auto nSeconds = static_cast<uint32_t>(nMillis / 1000);
+
+		FixedLineWriter writer(szLine, LINE_CAPACITY);
+		writer.Append("[");
+		writer.AppendNumber(static_cast<uint32_t>(static_cast<int>(ymd.year())), 4);
+		writer.Append("-");
+		writer.AppendNumber(static_cast<unsigned>(ymd.month()), 2);
+		writer.Append("-");
+		writer.AppendNumber(static_cast<unsigned>(ymd.day()), 2);
+		writer.Append(" ");
+		writer.AppendNumber(nSeconds / 3600, 2);
+		writer.Append(":");
+		writer.AppendNumber(nSeconds / 60 % 60, 2);
+		writer.Append(":");
+		writer.AppendNumber(nSeconds % 60, 2);
+		writer.Append(".");
+		writer.AppendNumber(static_cast<uint32_t>(nMillis % 1000), 3);
+		writer.Append("] [");
+		writer.Append(GetPaddedLevelName(level));
+		writer.Append("]  ");
+		if (pcszFuncName) {
+			writer.AppendText(pcszFuncName, std::char_traits<TCHAR>::length(pcszFuncName));
+		}
+		writer.Append(": ");
+		writer.AppendText(szMsg, std::min(nLength, MESSAGE_CAPACITY));
+
+		// 换行符总是保留，截断时覆盖最后两个字节
+		const size_t nSize = std::min(writer.GetSize(), LINE_CAPACITY - 2);
+		szLine[nSize]      = '\r';
+		szLine[nSize + 1]  = '\n';
+		return nSize + 2;
+	}
+};
+
+LogFlightRecorder::LogFlightRecorder(size_t p_nCapacity, const String& pc_strDumpPath)
+    : m_strDumpPath_(pc_strDumpPath)
+    , m_pDumpBuffer_(std::make_unique<DumpBuffer_>()) {
+	const size_t nCapacity = std::bit_ceil(std::max<size_t>(p_nCapacity, 2));
+	m_pSlots_              = std::make_unique<Slot_[]>(nCapacity);
+	m_nMask_               = nCapacity - 1;
+
+	// 崩溃时不能再创建目录
+	const std::filesystem::path path(m_strDumpPath_);
+	if (path.has_parent_path()) {
+		std::error_code ec;
+		std::filesystem::create_directories(path.parent_path(), ec);
+	}
+
+	// 先链好自身再发布，崩溃时的遍历不会看到半初始化的节点
+	std::lock_guard<std::mutex> guard(g_mtxRecorders);
+	LogFlightRecorder* pHead = g_pRecorders.load(std::memory_order_relaxed);
+	if (!pHead) {
+		InstallHandlers();
+	}
+	m_pNext_.store(pHead, std::memory_order_relaxed);
+	g_pRecorders.store(this, std::memory_order_release);
+}
+
+LogFlightRecorder::~LogFlightRecorder() {
+	std::lock_guard<std::mutex> guard(g_mtxRecorders);
+	std::atomic<LogFlightRecorder*>* pLink = &g_pRecorders;
+	while (LogFlightRecorder* pRecorder = pLink->load(std::memory_order_relaxed)) {
+		if (pRecorder == this) {
+			pLink->store(m_pNext_.load(std::memory_order_relaxed), std::memory_order_release);
+			break;
+		}
+		pLink = &pRecorder->m_pNext_;
+	}
+
+	if (!g_pRecorders.load(std::memory_order_relaxed)) {
+		RestoreHandlers();
+	}
+}
+
+void LogFlightRecorder::Record(const DateTime& pc_dtTime, LogLevel p_level, const TCHAR* p_cszFuncName, StringView p_svMsg) noexcept {
+	const uint64_t nIndex = m_nHead_.fetch_add(1, std::memory_order_relaxed);
+	Slot_& slot           = m_pSlots_[nIndex & m_nMask_];
+
+	// 只能占用已写完且属于更早记录的格；其他线程正在写入或已被更新的记录占用时放弃本条，宁可丢失也不写出撕裂的记录
+	uint64_t nSeq = slot.nSeq.load(std::memory_order_relaxed);
+	do {
+		if ((nSeq & 1) != 0 || nSeq > nIndex * 2) {
+			return;
+		}
+	} while (!slot.nSeq.compare_exchange_weak(nSeq, nIndex * 2 + 1, std::memory_order_relaxed));
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.dtTime       = pc_dtTime;
+	slot.level        = p_level;
+	slot.pcszFuncName = p_cszFuncName;
+	slot.nLength      = std::min(p_svMsg.size(), MESSAGE_CAPACITY);
+	std::memcpy(slot.szMsg, p_svMsg.data(), slot.nLength * sizeof(TCHAR));
+
+	slot.nSeq.store(nIndex * 2 + 2, std::memory_order_release);
+}
+
+bool LogFlightRecorder::Dump() const noexcept {
+	return this->Dump(m_strDumpPath_);
+}
+
+bool LogFlightRecorder::Dump(const String& pc_strPath) const noexcept {
+	if (m_bDumping_.test_and_set(std::memory_order_acquire)) {
+		return false;
+	}
+
+	const HANDLE hFile = ::CreateFile(pc_strPath.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	bool bSuccess      = hFile != INVALID_HANDLE_VALUE;
+	if (bSuccess) {
+		DumpBuffer_& buffer      = *m_pDumpBuffer_;
+		const uint64_t nHead     = m_nHead_.load(std::memory_order_acquire);
+		const uint64_t nCapacity = m_nMask_ + 1;
+
+		// 按记录序号由旧到新读取，格中的顺序号不是该序号写完后的值时，该记录已被覆盖、未写完或被放弃，直接跳过
+		for (uint64_t nIndex = nHead > nCapacity ? nHead - nCapacity : 0; nIndex < nHead && bSuccess; ++nIndex) {
+			const Slot_& slot   = m_pSlots_[nIndex & m_nMask_];
+			const uint64_t nSeq = nIndex * 2 + 2;
+			if (slot.nSeq.load(std::memory_order_acquire) != nSeq) {
+				continue;
+			}
+
+			buffer.dtTime       = slot.dtTime;
+			buffer.level        = slot.level;
+			buffer.pcszFuncName = slot.pcszFuncName;
+			buffer.nLength      = std::min(slot.nLength, MESSAGE_CAPACITY);
+			std::memcpy(buffer.szMsg, slot.szMsg, buffer.nLength * sizeof(TCHAR));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.nSeq.load(std::memory_order_relaxed) != nSeq) {
+				continue;
+			}
+
+			const DWORD dwSize = static_cast<DWORD>(buffer.FormatLine());
+			DWORD dwWritten    = 0;
+			bSuccess           = ::WriteFile(hFile, buffer.szLine, dwSize, &dwWritten, NULL) && dwWritten == dwSize;
+		}
+		::CloseHandle(hFile);
+	}
+
+	m_bDumping_.clear(std::memory_order_release);
+	return bSuccess;
+}
+
+void LogFlightRecorder::DumpAll() noexcept {
+	const LogFlightRecorder* pRecorder = g_pRecorders.load(std::memory_order_acquire);
+	for (; pRecorder; pRecorder = pRecorder->m_pNext_.load(std::memory_order_acquire)) {
+		pRecorder->Dump();
+	}
+}
+
+_UTILS_END
\ No newline at end of file
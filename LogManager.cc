@@ -0,0 +1,366 @@
+#include "LogManager.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include "Logger.h"
+
+_UTILS_BEGIN
+
+namespace {
+	/// <summary>
+	/// 去除首尾的空白字符
+	/// </summary>
+	StringView TrimBlanks(StringView p_svValue) noexcept {
+		constexpr StringView svBlanks = TEXT(" \t\r\n");
+
+		const size_t nBegin = p_svValue.find_first_not_of(svBlanks);
+		if (nBegin == StringView::npos) {
+			return StringView();
+		}
+		return p_svValue.substr(nBegin, p_svValue.find_last_not_of(svBlanks) - nBegin + 1);
+	}
+
+	/// <summary>
+	/// 解析配置文件中的级别名称，不区分大小写
+	/// </summary>
+	std::optional<LogLevel> ParseLevel(StringView p_svValue) {
+		String strValue(p_svValue);
+		::CharUpperBuff(strValue.data(), static_cast<DWORD>(strValue.size()));
+		if (strValue == TEXT("TRACE")) {
+			return LogLevel::TRACE;
+		} else if (strValue == TEXT("DEBUG")) {
+			return LogLevel::DEBUG;
+		} else if (strValue == TEXT("INFO")) {
+			return LogLevel::INFO;
+		} else if (strValue == TEXT("WARN")) {
+			return LogLevel::WARN;
+		} else if (strValue == TEXT("ERROR") || strValue == TEXT("ERR")) {
+			return LogLevel::ERR;
+		} else if (strValue == TEXT("NONE")) {
+			return LogLevel::NONE;
+		}
+		return std::nullopt;
+	}
+
+	/// <summary>
+	/// 计算调用点对给定 Logger 的状态：Logger 的地址，最低位为是否启用
+	/// </summary>
+	uintptr_t ComputeSiteState(LogSiteMode p_mode, bool p_bLevelEnabled, const Logger* p_pLogger) noexcept {
+		const bool bEnabled = p_mode == LogSiteMode::DEFAULT ? p_bLevelEnabled : p_mode == LogSiteMode::ENABLED;
+		return reinterpret_cast<uintptr_t>(p_pLogger) | (bEnabled ? 1 : 0);
+	}
+}
+
+std::shared_ptr<SharedLogFile> LogManager::Acquire(const String& pc_strDirectory, const String& pc_strName, const TCHAR* p_cszExtension) {
+	std::error_code ec;
+	std::filesystem::path path = std::filesystem::absolute(std::filesystem::path(pc_strDirectory), ec);
+	if (ec) {
+		path = std::filesystem::path(pc_strDirectory);
+	}
+
+	// Windows 的路径不区分大小写
+	String strKey = (path.lexically_normal() / FORMAT("{}.{}", pc_strName, p_cszExtension)).native();
+	::CharLowerBuff(strKey.data(), static_cast<DWORD>(strKey.size()));
+
+	std::lock_guard<std::mutex> guard(m_mtxFiles_);
+	if (const auto iter = m_mapFiles_.find(strKey); iter != m_mapFiles_.end()) {
+		if (auto pFile = iter->second.lock()) {
+			return pFile;
+		}
+	}
+
+	// 顺带清理已无人使用的条目
+	std::erase_if(m_mapFiles_, [](const auto& pc_pair) { return pc_pair.second.expired(); });
+
+	auto pFile          = std::make_shared<SharedLogFile>();
+	m_mapFiles_[strKey] = pFile;
+	return pFile;
+}
+
+size_t LogManager::GetFileCount() {
+	std::lock_guard<std::mutex> guard(m_mtxFiles_);
+	return std::count_if(m_mapFiles_.begin(), m_mapFiles_.end(), [](const auto& pc_pair) { return !pc_pair.second.expired(); });
+}
+
+LogManager::~LogManager() {
+	this->StopWatching();
+}
+
+void LogManager::Register_(Logger* p_pLogger) {
+	std::lock_guard<std::mutex> guard(m_mtxLoggers_);
+	m_vLoggers_.push_back(p_pLogger);
+	if (const auto level = this->FindLevel_(p_pLogger->GetName())) {
+		p_pLogger->SetLogLevel(*level);
+	}
+}
+
+void LogManager::Unregister_(Logger* p_pLogger) {
+	std::lock_guard<std::mutex> guard(m_mtxLoggers_);
+	std::erase(m_vLoggers_, p_pLogger);
+}
+
+std::optional<LogLevel> LogManager::FindLevel_(const String& pc_strName) const {
+	if (const auto iter = m_mapLevels_.find(pc_strName); iter != m_mapLevels_.end()) {
+		return iter->second;
+	}
+	if (const auto iter = m_mapLevels_.find(TEXT("*")); iter != m_mapLevels_.end()) {
+		return iter->second;
+	}
+	return std::nullopt;
+}
+
+bool LogManager::LoadConfig(const String& pc_strPath) {
+	std::ifstream ifs(std::filesystem::path(pc_strPath), std::ios::binary);
+	if (!ifs.is_open()) {
+		return false;
+	}
+
+	const std::string strBytes((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	if (ifs.bad()) {
+		return false;
+	}
+
+	// 跳过UTF-8的字节顺序标记
+	constexpr std::string_view svBom = "\xEF\xBB\xBF";
+	const size_t nBomSize            = strBytes.starts_with(svBom) ? svBom.size() : 0;
+
+	std::unordered_map<String, LogLevel> mapLevels;
+	const String strText = StringUtils::ToCurrentEncodingString(strBytes.substr(nBomSize));
+	for (size_t nBegin = 0; nBegin < strText.size();) {
+		const size_t nEnd       = std::min(strText.find(TEXT('\n'), nBegin), strText.size());
+		const StringView svLine = TrimBlanks(StringView(strText).substr(nBegin, nEnd - nBegin));
+		nBegin                  = nEnd + 1;
+
+		const size_t nEqual = svLine.find(TEXT('='));
+		if (svLine.empty() || svLine[0] == TEXT('#') || nEqual == StringView::npos) {
+			continue;
+		}
+
+		const StringView svName = TrimBlanks(svLine.substr(0, nEqual));
+		if (const auto level = ParseLevel(TrimBlanks(svLine.substr(nEqual + 1))); level && !svName.empty()) {
+			mapLevels[String(svName)] = *level;
+		}
+	}
+
+	std::lock_guard<std::mutex> guard(m_mtxLoggers_);
+	m_mapLevels_ = std::move(mapLevels);
+	for (Logger* pLogger : m_vLoggers_) {
+		if (const auto level = this->FindLevel_(pLogger->GetName())) {
+			pLogger->SetLogLevel(*level);
+		}
+	}
+	return true;
+}
+
+bool LogManager::WatchConfig(const String& pc_strPath) {
+	this->StopWatching();
+
+	std::lock_guard<std::mutex> guard(m_mtxWatch_);
+	m_hStopEvent_ = ::CreateEvent(nullptr, TRUE, FALSE, nullptr);
+	if (!m_hStopEvent_) {
+		return false;
+	}
+
+	std::error_code ec;
+	m_strConfigPath_ = std::filesystem::absolute(std::filesystem::path(pc_strPath), ec).native();
+	if (ec) {
+		m_strConfigPath_ = pc_strPath;
+	}
+	this->LoadConfig(m_strConfigPath_);
+	m_thWatcher_ = std::thread(&LogManager::WatchLoop_, this, m_strConfigPath_, m_hStopEvent_);
+	return true;
+}
+
+void LogManager::StopWatching() {
+	std::lock_guard<std::mutex> guard(m_mtxWatch_);
+	if (m_thWatcher_.joinable()) {
+		::SetEvent(m_hStopEvent_);
+		m_thWatcher_.join();
+	}
+	if (m_hStopEvent_) {
+		::CloseHandle(m_hStopEvent_);
+		m_hStopEvent_ = nullptr;
+	}
+	m_strConfigPath_.clear();
+}
+
+void LogManager::WatchLoop_(String p_strPath, HANDLE p_hStopEvent) {
+	const std::filesystem::path path(p_strPath);
+	const std::wstring wstrFileName = path.filename().wstring();
+
+	const HANDLE hDirectory = ::CreateFile(path.parent_path().c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+	    nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+	if (hDirectory == INVALID_HANDLE_VALUE) {
+		return;
+	}
+
+	OVERLAPPED overlapped {};
+	overlapped.hEvent = ::CreateEvent(nullptr, TRUE, FALSE, nullptr);
+	if (!overlapped.hEvent) {
+		::CloseHandle(hDirectory);
+		return;
+	}
+
+	alignas(DWORD) BYTE arrBuffer[4096];
+	const HANDLE arrHandles[] = { p_hStopEvent, overlapped.hEvent };
+	for (;;) {
+		::ResetEvent(overlapped.hEvent);
+		if (!::ReadDirectoryChangesW(hDirectory, arrBuffer, sizeof(arrBuffer), FALSE,
+		        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE, nullptr, &overlapped, nullptr)) {
+			break;
+		}
+
+		DWORD dwBytes = 0;
+		if (::WaitForMultipleObjects(2, arrHandles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1) {
+			::CancelIoEx(hDirectory, &overlapped);
+			::GetOverlappedResult(hDirectory, &overlapped, &dwBytes, TRUE);
+			break;
+		}
+		if (!::GetOverlappedResult(hDirectory, &overlapped, &dwBytes, FALSE)) {
+			break;
+		}
+
+		// 通知过多导致缓冲区溢出时 dwBytes 为0，此时无法确定配置文件是否变化，直接重新读取
+		bool bChanged = dwBytes == 0;
+		for (DWORD dwOffset = 0; !bChanged;) {
+			const auto* pInfo = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(arrBuffer + dwOffset);
+			bChanged = ::CompareStringOrdinal(pInfo->FileName, static_cast<int>(pInfo->FileNameLength / sizeof(WCHAR)), wstrFileName.c_str(),
+			               static_cast<int>(wstrFileName.size()), TRUE)
+			        == CSTR_EQUAL;
+			if (pInfo->NextEntryOffset == 0) {
+				break;
+			}
+			dwOffset += pInfo->NextEntryOffset;
+		}
+
+		// 编辑器保存时通常连续产生多个通知，且文件可能仍被占用，稍后再读取
+		if (bChanged) {
+			if (::WaitForSingleObject(p_hStopEvent, 100) == WAIT_OBJECT_0) {
+				break;
+			}
+			this->LoadConfig(p_strPath);
+		}
+	}
+
+	::CloseHandle(overlapped.hEvent);
+	::CloseHandle(hDirectory);
+}
+
+void LogManager::RegisterSite_(LogSiteGate* p_pSite) {
+	std::lock_guard<std::mutex> guard(m_mtxSites_);
+	p_pSite->m_nId_ = m_nNextSiteId_++;
+	m_vSites_.push_back(p_pSite);
+}
+
+void LogManager::UnregisterSite_(LogSiteGate* p_pSite) {
+	std::lock_guard<std::mutex> guard(m_mtxSites_);
+	std::erase(m_vSites_, p_pSite);
+}
+
+bool LogManager::BindSite_(LogSiteGate* p_pSite, const Logger* p_pLogger) {
+	std::lock_guard<std::mutex> guard(m_mtxSites_);
+	const uintptr_t nState = ComputeSiteState(p_pSite->m_mode_, p_pLogger->IsLevelEnabled_(p_pSite->m_level_), p_pLogger);
+	p_pSite->m_nState_.store(nState, std::memory_order_relaxed);
+	return (nState & 1) != 0;
+}
+
+void LogManager::RefreshSites_(const Logger* p_pLogger) {
+	std::lock_guard<std::mutex> guard(m_mtxSites_);
+	for (LogSiteGate* pSite : m_vSites_) {
+		const uintptr_t nState = pSite->m_nState_.load(std::memory_order_relaxed);
+		if ((nState & ~uintptr_t(1)) == reinterpret_cast<uintptr_t>(p_pLogger)) {
+			pSite->m_nState_.store(
+			    ComputeSiteState(pSite->m_mode_, p_pLogger->IsLevelEnabled_(pSite->m_level_), p_pLogger), std::memory_order_relaxed);
+		}
+	}
+}
+
+void LogManager::UnbindSites_(const Logger* p_pLogger) {
+	// 解除绑定，避免之后在同一地址创建的 Logger 沿用旧状态
+	std::lock_guard<std::mutex> guard(m_mtxSites_);
+	for (LogSiteGate* pSite : m_vSites_) {
+		const uintptr_t nState = pSite->m_nState_.load(std::memory_order_relaxed);
+		if ((nState & ~uintptr_t(1)) == reinterpret_cast<uintptr_t>(p_pLogger)) {
+			pSite->m_nState_.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+void LogManager::RegisterLimiter_(LogRateLimiter* p_pLimiter) {
+	std::lock_guard<std::mutex> guard(m_mtxLimiters_);
+	m_vLimiters_.push_back(p_pLimiter);
+}
+
+void LogManager::UnregisterLimiter_(LogRateLimiter* p_pLimiter) {
+	std::lock_guard<std::mutex> guard(m_mtxLimiters_);
+	std::erase(m_vLimiters_, p_pLimiter);
+}
+
+void LogManager::FlushSuppressed_(const Logger* p_pLogger) {
+	struct Pending {
+		LogLevel level;
+		LPCTSTR cszFuncName;
+		size_t nSuppressed;
+	};
+
+	// 在锁外写入汇总记录，写入时可能再次进入限流器
+	std::vector<Pending> vPending;
+	{
+		std::lock_guard<std::mutex> guard(m_mtxLimiters_);
+		for (LogRateLimiter* pLimiter : m_vLimiters_) {
+			if (pLimiter->m_pLogger_.load(std::memory_order_relaxed) != p_pLogger || !pLimiter->m_bPending_.load(std::memory_order_relaxed)) {
+				continue;
+			}
+			pLimiter->m_bPending_.store(false, std::memory_order_relaxed);
+			if (const size_t nSuppressed = pLimiter->m_nSuppressed_.exchange(0, std::memory_order_relaxed)) {
+				vPending.push_back({ pLimiter->m_level_.load(std::memory_order_relaxed), pLimiter->m_cszFuncName_, nSuppressed });
+			}
+		}
+	}
+
+	for (const auto& pending : vPending) {
+		p_pLogger->LogSuppressed_(pending.level, pending.cszFuncName, pending.nSuppressed);
+	}
+}
+
+void LogManager::UnbindLimiters_(const Logger* p_pLogger) {
+	std::lock_guard<std::mutex> guard(m_mtxLimiters_);
+	for (LogRateLimiter* pLimiter : m_vLimiters_) {
+		const Logger* pExpected = p_pLogger;
+		pLimiter->m_pLogger_.compare_exchange_strong(pExpected, nullptr, std::memory_order_relaxed);
+	}
+}
+
+std::vector<LogSiteInfo> LogManager::GetSites() {
+	std::lock_guard<std::mutex> guard(m_mtxSites_);
+
+	std::vector<LogSiteInfo> vSites;
+	vSites.reserve(m_vSites_.size());
+	for (const LogSiteGate* pSite : m_vSites_) {
+		vSites.push_back({ pSite->m_nId_, pSite->m_level_, pSite->m_cszFuncName_, pSite->m_cszFile_, pSite->m_nLine_, pSite->m_mode_,
+		    (pSite->m_nState_.load(std::memory_order_relaxed) & 1) != 0 });
+	}
+	std::sort(vSites.begin(), vSites.end(), [](const LogSiteInfo& pc_left, const LogSiteInfo& pc_right) { return pc_left.nId < pc_right.nId; });
+	return vSites;
+}
+
+bool LogManager::SetSiteMode(uint32_t p_nId, LogSiteMode p_mode) {
+	std::lock_guard<std::mutex> guard(m_mtxSites_);
+	const auto iter = std::find_if(m_vSites_.begin(), m_vSites_.end(), [p_nId](const LogSiteGate* pc_pSite) { return pc_pSite->m_nId_ == p_nId; });
+	if (iter == m_vSites_.end()) {
+		return false;
+	}
+
+	// 未绑定的调用点在下一次调用时按新的开关计算状态
+	LogSiteGate* pSite = *iter;
+	pSite->m_mode_     = p_mode;
+	if (const uintptr_t nState = pSite->m_nState_.load(std::memory_order_relaxed); nState != 0) {
+		const auto* pLogger = reinterpret_cast<const Logger*>(nState & ~uintptr_t(1));
+		pSite->m_nState_.store(ComputeSiteState(p_mode, pLogger->IsLevelEnabled_(pSite->m_level_), pLogger), std::memory_order_relaxed);
+	}
+	return true;
+}
+
+_UTILS_END
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "LogSink.h"
+
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <new>
+
+#include "Exception.h"
+
+_UTILS_BEGIN
+
+namespace {
+	/// <summary>
+	/// 发送整段数据，对端关闭或出错时返回false
+	/// </summary>
+	bool SendAll(SOCKET p_socket, const char* p_pData, size_t p_nSize) {
+		while (p_nSize > 0) {
+			const int nSent = ::send(p_socket, p_pData, static_cast<int>(std::min<size_t>(p_nSize, INT_MAX)), 0);
+			if (nSent == SOCKET_ERROR) {
+				return false;
+			}
+			p_pData += nSent;
+			p_nSize -= static_cast<size_t>(nSent);
+		}
+		return true;
+	}
+}
+
+LogSink::LogSink(LogLevel p_level)
+    : m_level_(p_level) {
+}
+
+FileLogSink::FileLogSink(const String& pc_strPath, LogLevel p_level)
+    : LogSink(p_level) {
+	const std::filesystem::path path(pc_strPath);
+	std::error_code ec;
+	if (path.has_parent_path()) {
+		std::filesystem::create_directories(path.parent_path(), ec);
+	}
+
+	if (!m_writer_.Open(pc_strPath, false)) {
+		throw InvalidArgumentException(pc_strPath.c_str());
+	}
+}
+
+void FileLogSink::Write(const LogSinkRecord& pc_record) {
+	std::lock_guard<std::mutex> guard(m_mtxWrite_);
+	m_writer_.Write(pc_record.svBytes.data(), pc_record.svBytes.size());
+	m_writer_.Flush();
+}
+
+void FileLogSink::Flush() {
+	std::lock_guard<std::mutex> guard(m_mtxWrite_);
+	m_writer_.Flush();
+}
+
+void StdErrLogSink::Write(const LogSinkRecord& pc_record) {
+	// 整行一次写出，CRT 保证单次调用不会与其他线程的输出交错
+	std::fwrite(pc_record.svBytes.data(), 1, pc_record.svBytes.size(), stderr);
+}
+
+void StdErrLogSink::Flush() {
+	std::fflush(stderr);
+}
+
+void DebugOutputLogSink::Write(const LogSinkRecord& pc_record) {
+	::OutputDebugString(pc_record.svLine.data());
+}
+
+MemoryLogSink::MemoryLogSink(size_t p_nCapacity, LogLevel p_level)
+    : LogSink(p_level)
+    , m_vLines_(std::max<size_t>(p_nCapacity, 1)) {
+}
+
+void MemoryLogSink::Write(const LogSinkRecord& pc_record) {
+	std::lock_guard<std::mutex> guard(m_mtxLines_);
+	m_vLines_[m_nNext_].assign(pc_record.svLine);
+	m_nNext_  = (m_nNext_ + 1) % m_vLines_.size();
+	m_nCount_ = std::min(m_nCount_ + 1, m_vLines_.size());
+}
+
+std::vector<String> MemoryLogSink::GetLines() const {
+	std::lock_guard<std::mutex> guard(m_mtxLines_);
+
+	std::vector<String> vLines;
+	vLines.reserve(m_nCount_);
+	const size_t nFirst = (m_nNext_ + m_vLines_.size() - m_nCount_) % m_vLines_.size();
+	for (size_t idx = 0; idx < m_nCount_; ++idx) {
+		vLines.push_back(m_vLines_[(nFirst + idx) % m_vLines_.size()]);
+	}
+	return vLines;
+}
+
+void MemoryLogSink::Clear() {
+	std::lock_guard<std::mutex> guard(m_mtxLines_);
+	m_nNext_  = 0;
+	m_nCount_ = 0;
+}
+
+CallbackLogSink::CallbackLogSink(Callback p_fnCallback, LogLevel p_level)
+    : LogSink(p_level)
+    , m_fnCallback_(std::move(p_fnCallback)) {
+}
+
+void CallbackLogSink::Write(const LogSinkRecord& pc_record) {
+	if (m_fnCallback_) {
+		m_fnCallback_(pc_record);
+	}
+}
+
+SocketLogSink::SocketLogSink(uint16_t p_nPort, LogLevel p_level, size_t p_nCapacity, const String& pc_strHost)
+    : LogSink(p_level)
+    , m_strHost_(pc_strHost)
+    , m_nPort_(p_nPort)
+    , m_queue_(p_nCapacity) {
+	WSADATA wsaData;
+	if (::WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+		throw InvalidArgumentException(TEXT("Winsock 初始化失败"));
+	}
+	m_thSender_ = std::thread(&SocketLogSink::SendLoop_, this);
+}
+
+SocketLogSink::~SocketLogSink() {
+	{
+		std::lock_guard<std::mutex> guard(m_mtxSender_);
+		m_bStopping_.store(true, std::memory_order_release);
+	}
+	m_cvSender_.notify_one();
+	m_thSender_.join();
+	::WSACleanup();
+}
+
+void SocketLogSink::Write(const LogSinkRecord& pc_record) {
+	if (pc_record.svBytes.size() > MAX_FRAME_SIZE) {
+		m_nDropped_.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// 就地写入队列中的缓冲，缓冲与发送线程交换后循环使用，稳定后不再分配内存
+	const bool bPushed = m_queue_.TryPushWith([&pc_record](std::string& p_strSlot) noexcept {
+		try {
+			p_strSlot.assign(pc_record.svBytes);
+		} catch (const std::bad_alloc&) {
+			p_strSlot.clear();
+		}
+	});
+	if (!bPushed) {
+		m_nDropped_.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// 不加锁通知：发送线程若恰好错过，最迟 FLUSH_INTERVAL 后也会醒来
+	if (m_queue_.GetPushedCount() % WAKE_BATCH_SIZE == 0) {
+		m_cvSender_.notify_one();
+	}
+}
+
+void SocketLogSink::Flush() {
+	this->Flush(std::chrono::seconds(1));
+}
+
+bool SocketLogSink::Flush(std::chrono::milliseconds p_timeout) {
+	const size_t nTarget = m_queue_.GetPushedCount();
+	m_cvSender_.notify_one();
+
+	std::unique_lock<std::mutex> lock(m_mtxSender_);
+	return m_cvSent_.wait_for(lock, p_timeout, [this, nTarget]() { return m_nSent_.load(std::memory_order_acquire) >= nTarget; });
+}
+
+uintptr_t SocketLogSink::Connect_() const {
+	ADDRINFOT hints {};
+	hints.ai_family   = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+
+	ADDRINFOT* pResult = nullptr;
+	if (::GetAddrInfo(m_strHost_.c_str(), FORMAT("{}", m_nPort_).c_str(), &hints, &pResult) != 0) {
+		return INVALID_SOCKET;
+	}
+
+	SOCKET sock = INVALID_SOCKET;
+	for (const ADDRINFOT* pAddr = pResult; pAddr; pAddr = pAddr->ai_next) {
+		sock = ::socket(pAddr->ai_family, pAddr->ai_socktype, pAddr->ai_protocol);
+		if (sock == INVALID_SOCKET) {
+			continue;
+		}
+		if (::connect(sock, pAddr->ai_addr, static_cast<int>(pAddr->ai_addrlen)) == 0) {
+			break;
+		}
+		::closesocket(sock);
+		sock = INVALID_SOCKET;
+	}
+	::FreeAddrInfo(pResult);
+
+	if (sock != INVALID_SOCKET) {
+		const BOOL bNoDelay = TRUE;
+		::setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&bNoDelay), sizeof(bNoDelay));
+	}
+	return sock;
+}
+
+void SocketLogSink::SendLoop_() {
+	using SteadyClock = std::chrono::steady_clock;
+
+	SOCKET sock                       = INVALID_SOCKET;
+	std::chrono::milliseconds backoff = MIN_BACKOFF;
+	SteadyClock::time_point tpRetry {};
+
+	// 帧头的长度在组帧完成后回填；未发出的帧保留到重连后重发，bPending 表示 strRecord 中有一条放不进上一帧的记录
+	std::string strFrame;
+	std::string strRecord;
+	size_t nFrameRecords = 0;
+	bool bPending        = false;
+
+	for (;;) {
+		const bool bStopping = m_bStopping_.load(std::memory_order_acquire);
+
+		if (nFrameRecords == 0) {
+			strFrame.assign(sizeof(uint32_t), '\0');
+			for (;;) {
+				if (!bPending && !m_queue_.TryPopWith([&strRecord](std::string& p_strSlot) noexcept { strRecord.swap(p_strSlot); })) {
+					break;
+				}
+				if (nFrameRecords != 0 && strFrame.size() - sizeof(uint32_t) + strRecord.size() > MAX_FRAME_SIZE) {
+					bPending = true; // 留到下一帧
+					break;
+				}
+				strFrame.append(strRecord);
+				++nFrameRecords;
+				bPending = false;
+			}
+
+			const uint32_t nPayload = static_cast<uint32_t>(strFrame.size() - sizeof(uint32_t));
+			std::memcpy(strFrame.data(), &nPayload, sizeof(nPayload));
+		}
+
+		if (nFrameRecords != 0) {
+			if (sock == INVALID_SOCKET && (bStopping || SteadyClock::now() >= tpRetry)) {
+				sock = static_cast<SOCKET>(this->Connect_());
+				if (sock == INVALID_SOCKET) {
+					tpRetry = SteadyClock::now() + backoff;
+					backoff = std::min(backoff * 2, MAX_BACKOFF);
+				} else {
+					backoff = MIN_BACKOFF;
+				}
+				m_bConnected_.store(sock != INVALID_SOCKET, std::memory_order_relaxed);
+			}
+
+			if (sock != INVALID_SOCKET) {
+				if (SendAll(sock, strFrame.data(), strFrame.size())) {
+					{
+						std::lock_guard<std::mutex> guard(m_mtxSender_);
+						m_nSent_.fetch_add(nFrameRecords, std::memory_order_release);
+					}
+					m_cvSent_.notify_all();
+					nFrameRecords = 0;
+					continue;
+				}
+
+				// 对端未收全的帧随连接一起作废，重连后整帧重发
+				::closesocket(sock);
+				sock    = INVALID_SOCKET;
+				tpRetry = SteadyClock::now() + backoff;
+				backoff = std::min(backoff * 2, MAX_BACKOFF);
+				m_bConnected_.store(false, std::memory_order_relaxed);
+			}
+		}
+
+		if (bStopping) {
+			break;
+		}
+
+		const auto fnStopping = [this]() { return m_bStopping_.load(std::memory_order_acquire); };
+		std::unique_lock<std::mutex> lock(m_mtxSender_);
+		if (nFrameRecords == 0) {
+			m_cvSender_.wait_for(lock, FLUSH_INTERVAL, fnStopping);
+		} else {
+			m_cvSender_.wait_until(lock, tpRetry, fnStopping);
+		}
+	}
+
+	if (sock != INVALID_SOCKET) {
+		::shutdown(sock, SD_SEND);
+		::closesocket(sock);
+	}
+	m_bConnected_.store(false, std::memory_order_relaxed);
+}
+
+_UTILS_END
\ No newline at end of file
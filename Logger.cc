@@ -1,75 +1,1295 @@
 #include "Logger.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <filesystem>
 
-#include "DateTimeUtils.h"
+#include "Compression.h"
 
 _UTILS_BEGIN
 
+namespace {
+	/// <summary>
+	/// 进程内下一个调用点的编号
+	/// </summary>
+	std::atomic<uint32_t> g_nNextCallSiteId { 0 };
+
+	/// <summary>
+	/// 在作用域内以后台模式运行当前线程，同时降低CPU与磁盘I/O的优先级。
+	/// <para>期间不应获取与前台线程共用的锁，否则前台线程会等待被降速的操作</para>
+	/// </summary>
+	class BackgroundModeScope {
+	public:
+		BackgroundModeScope() noexcept {
+			::SetThreadPriority(::GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+		}
+
+		BackgroundModeScope(const BackgroundModeScope&)            = delete;
+		BackgroundModeScope& operator=(const BackgroundModeScope&) = delete;
+
+		~BackgroundModeScope() {
+			::SetThreadPriority(::GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+		}
+	};
+
+	/// <summary>
+	/// 解析日志文件名中日期之后的部分，格式为 ext、N.ext 或其压缩形式
+	/// </summary>
+	bool ParseSegment(const String& pc_strFileName, size_t p_nPos, StringView p_svExtension, size_t& p_nSegment, bool& p_bCompressed) {
+		const size_t nStart = p_nPos;
+		p_nSegment          = 0;
+		for (; p_nPos < pc_strFileName.size() && TEXT('0') <= pc_strFileName[p_nPos] && pc_strFileName[p_nPos] <= TEXT('9'); ++p_nPos) {
+			p_nSegment = p_nSegment * 10 + (pc_strFileName[p_nPos] - TEXT('0'));
+		}
+		if (p_nPos != nStart) {
+			if (p_nPos >= pc_strFileName.size() || pc_strFileName[p_nPos] != TEXT('.')) {
+				return false;
+			}
+			++p_nPos;
+		}
+
+		const StringView svRest = StringView(pc_strFileName).substr(p_nPos);
+		p_bCompressed           = svRest.starts_with(p_svExtension) && svRest.substr(p_svExtension.size()) == CompressionUtils::FILE_EXTENSION;
+		return p_bCompressed || svRest == p_svExtension;
+	}
+
+	/// <summary>
+	/// 每个线程缓存的时间戳前缀 "[YYYY-mm-dd HH:MM:SS."，仅在秒数变化时重新生成
+	/// </summary>
+	struct TimestampCache {
+		int64_t nSeconds = INT64_MIN;
+		TCHAR szPrefix[32] {};
+		size_t nPrefixLen = 0;
+	};
+
+	/// <summary>
+	/// 追加 "[YYYY-mm-dd HH:MM:SS.mmm"，同一秒内只需改写毫秒的三位数字
+	/// </summary>
+	void AppendTimestamp(String& p_strOut, const DateTime& pc_dtTime) {
+		thread_local TimestampCache t_cache;
+
+		const auto dtSeconds   = std::chrono::floor<Seconds>(pc_dtTime);
+		const int64_t nSeconds = dtSeconds.time_since_epoch().count();
+		if (nSeconds != t_cache.nSeconds) {
+			const auto result = std::format_to_n(t_cache.szPrefix, std::size(t_cache.szPrefix), TEXT("[{:%Y-%m-%d %H:%M:%OS}."), dtSeconds);
+			t_cache.nPrefixLen = std::min<size_t>(result.size, std::size(t_cache.szPrefix));
+			t_cache.nSeconds   = nSeconds;
+		}
+
+		const auto nMillis       = std::chrono::duration_cast<MilliSeconds>(pc_dtTime - dtSeconds).count();
+		const TCHAR szMillis[3] = { static_cast<TCHAR>(TEXT('0') + nMillis / 100), static_cast<TCHAR>(TEXT('0') + nMillis / 10 % 10),
+			static_cast<TCHAR>(TEXT('0') + nMillis % 10) };
+
+		p_strOut.append(t_cache.szPrefix, t_cache.nPrefixLen);
+		p_strOut.append(szMillis, std::size(szMillis));
+	}
+
+	/// <summary>
+	/// 获取按5个字符宽度左对齐的级别名称
+	/// </summary>
+	StringView GetPaddedLevelName(LogLevel p_level) noexcept {
+		switch (p_level) {
+			case LogLevel::TRACE:
+				return TEXT("trace");
+			case LogLevel::DEBUG:
+				return TEXT("debug");
+			case LogLevel::INFO:
+				return TEXT("info ");
+			case LogLevel::WARN:
+				return TEXT("warn ");
+			case LogLevel::ERR:
+				return TEXT("error");
+			default:
+				return TEXT("     ");
+		}
+	}
+
+	/// <summary>
+	/// 将文本转为写入文件的字节，宽字符按UTF-8编码直接追加，多字节字符原样写入
+	/// </summary>
+	void AppendText(std::string& p_strBytes, StringView p_svText) {
+#ifdef _UNICODE
+		StringUtils::AppendUtf8(p_strBytes, p_svText);
+#else
+		p_strBytes.append(p_svText);
+#endif // _UNICODE
+	}
+
+	/// <summary>
+	/// 获取 JSON 中使用的级别名称
+	/// </summary>
+	std::string_view GetLevelName(LogLevel p_level) noexcept {
+		switch (p_level) {
+			case LogLevel::TRACE:
+				return "trace";
+			case LogLevel::DEBUG:
+				return "debug";
+			case LogLevel::INFO:
+				return "info";
+			case LogLevel::WARN:
+				return "warn";
+			case LogLevel::ERR:
+				return "error";
+			default:
+				return "none";
+		}
+	}
+
+	/// <summary>
+	/// 按给定宽度追加十进制数字，不足时补0
+	/// </summary>
+	void AppendDigits(std::string& p_strOut, unsigned p_nValue, size_t p_nWidth) {
+		char szDigits[8];
+		for (size_t idx = p_nWidth; idx > 0; --idx) {
+			szDigits[idx - 1] = static_cast<char>('0' + p_nValue % 10);
+			p_nValue /= 10;
+		}
+		p_strOut.append(szDigits, p_nWidth);
+	}
+
+	/// <summary>
+	/// 按 JSON 字符串的规则转义后追加，其余字符按UTF-8编码
+	/// </summary>
+	void AppendJsonString(std::string& p_strOut, StringView p_svValue) {
+		constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+		p_strOut.push_back('"');
+		size_t nStart = 0;
+		for (size_t idx = 0; idx < p_svValue.size(); ++idx) {
+			const auto ch = static_cast<std::make_unsigned_t<TCHAR>>(p_svValue[idx]);
+			if (ch >= 0x20 && ch != '"' && ch != '\\') {
+				continue;
+			}
+
+			AppendText(p_strOut, p_svValue.substr(nStart, idx - nStart));
+			nStart = idx + 1;
+			switch (ch) {
+				case '"':
+					p_strOut.append("\\\"");
+					break;
+				case '\\':
+					p_strOut.append("\\\\");
+					break;
+				case '\n':
+					p_strOut.append("\\n");
+					break;
+				case '\r':
+					p_strOut.append("\\r");
+					break;
+				case '\t':
+					p_strOut.append("\\t");
+					break;
+				default:
+					p_strOut.append("\\u00");
+					p_strOut.push_back(HEX_DIGITS[ch >> 4]);
+					p_strOut.push_back(HEX_DIGITS[ch & 0xF]);
+					break;
+			}
+		}
+		AppendText(p_strOut, p_svValue.substr(nStart));
+		p_strOut.push_back('"');
+	}
+
+	/// <summary>
+	/// 追加 "YYYY-mm-ddTHH:MM:SS.mmm"
+	/// </summary>
+	void AppendJsonDateTime(std::string& p_strOut, const DateTime& pc_dtTime) {
+		const auto dtDays = std::chrono::floor<Days>(pc_dtTime);
+		const Date date(dtDays);
+		const Time time(std::chrono::floor<MilliSeconds>(pc_dtTime - dtDays));
+
+		p_strOut.push_back('"');
+		AppendDigits(p_strOut, static_cast<unsigned>(static_cast<int>(date.year())), 4);
+		p_strOut.push_back('-');
+		AppendDigits(p_strOut, static_cast<unsigned>(date.month()), 2);
+		p_strOut.push_back('-');
+		AppendDigits(p_strOut, static_cast<unsigned>(date.day()), 2);
+		p_strOut.push_back('T');
+		AppendDigits(p_strOut, static_cast<unsigned>(time.hours().count()), 2);
+		p_strOut.push_back(':');
+		AppendDigits(p_strOut, static_cast<unsigned>(time.minutes().count()), 2);
+		p_strOut.push_back(':');
+		AppendDigits(p_strOut, static_cast<unsigned>(time.seconds().count()), 2);
+		p_strOut.push_back('.');
+		AppendDigits(p_strOut, static_cast<unsigned>(std::chrono::duration_cast<MilliSeconds>(time.subseconds()).count()), 3);
+		p_strOut.push_back('"');
+	}
+
+	/// <summary>
+	/// 按字段的类型追加 JSON 值，数值通过 std::to_chars 直接写入
+	/// </summary>
+	void AppendJsonValue(std::string& p_strOut, const LogField::Value& pc_value) {
+		std::visit(
+		    [&p_strOut](const auto& pc_fieldValue) {
+			    using _Type = std::decay_t<decltype(pc_fieldValue)>;
+			    if constexpr (std::is_same_v<_Type, bool>) {
+				    p_strOut.append(pc_fieldValue ? "true" : "false");
+			    } else if constexpr (std::is_same_v<_Type, StringView>) {
+				    AppendJsonString(p_strOut, pc_fieldValue);
+			    } else if constexpr (std::is_same_v<_Type, DateTime>) {
+				    AppendJsonDateTime(p_strOut, pc_fieldValue);
+			    } else {
+				    if constexpr (std::is_floating_point_v<_Type>) {
+					    if (!std::isfinite(pc_fieldValue)) {
+						    p_strOut.append("null");
+						    return;
+					    }
+				    }
+
+				    char szNumber[32];
+				    const auto result = std::to_chars(szNumber, szNumber + sizeof(szNumber), pc_fieldValue);
+				    p_strOut.append(szNumber, result.ptr);
+			    }
+		    },
+		    pc_value);
+	}
+
+	/// <summary>
+	/// 追加一行 JSON 对象，以'\n'结尾
+	/// </summary>
+	void AppendJsonLine(std::string& p_strOut, const DateTime& pc_dtTime, LogLevel p_level, const TCHAR* p_cszFuncName, StringView p_svMsg,
+	    std::span<const LogField> p_fields) {
+		p_strOut.append("{\"time\":");
+		AppendJsonDateTime(p_strOut, pc_dtTime);
+		p_strOut.append(",\"level\":\"");
+		p_strOut.append(GetLevelName(p_level));
+		p_strOut.append("\",\"func\":");
+		AppendJsonString(p_strOut, p_cszFuncName ? StringView(p_cszFuncName) : StringView());
+		p_strOut.append(",\"msg\":");
+		AppendJsonString(p_strOut, p_svMsg);
+
+		for (const auto& field : p_fields) {
+			p_strOut.push_back(',');
+			AppendJsonString(p_strOut, field.svKey);
+			p_strOut.push_back(':');
+			AppendJsonValue(p_strOut, field.value);
+		}
+		p_strOut.append("}\n");
+	}
+
+	/// <summary>
+	/// 以 " key=value" 的形式将字段追加到文本消息之后
+	/// </summary>
+	void AppendFieldsText(String& p_strOut, std::span<const LogField> p_fields) {
+		for (const auto& field : p_fields) {
+			p_strOut.push_back(TEXT(' '));
+			p_strOut.append(field.svKey);
+			p_strOut.push_back(TEXT('='));
+			std::visit(
+			    [&p_strOut](const auto& pc_fieldValue) {
+				    using _Type = std::decay_t<decltype(pc_fieldValue)>;
+				    if constexpr (std::is_same_v<_Type, bool>) {
+					    p_strOut.append(pc_fieldValue ? TEXT("true") : TEXT("false"));
+				    } else if constexpr (std::is_same_v<_Type, StringView>) {
+					    p_strOut.append(pc_fieldValue);
+				    } else if constexpr (std::is_same_v<_Type, DateTime>) {
+					    std::format_to(std::back_inserter(p_strOut), TEXT("{:%Y-%m-%d %H:%M:%S}"), std::chrono::floor<MilliSeconds>(pc_fieldValue));
+				    } else {
+					    std::format_to(std::back_inserter(p_strOut), TEXT("{}"), pc_fieldValue);
+				    }
+			    },
+			    field.value);
+		}
+	}
+}
+
+LogCallSite::LogCallSite(LPCTSTR p_cszFuncName, LPCTSTR p_cszFormat)
+    : m_nId_(g_nNextCallSiteId.fetch_add(1, std::memory_order_relaxed))
+    , m_cszFuncName_(p_cszFuncName)
+    , m_cszFormat_(p_cszFormat) {
+}
+
+LogSiteGate::LogSiteGate(LogLevel p_level, LPCTSTR p_cszFuncName, LPCTSTR p_cszFile, uint32_t p_nLine)
+    : m_level_(p_level)
+    , m_cszFuncName_(p_cszFuncName)
+    , m_cszFile_(p_cszFile)
+    , m_nLine_(p_nLine) {
+	LogManager::GetInstance().RegisterSite_(this);
+}
+
+LogSiteGate::~LogSiteGate() {
+	LogManager::GetInstance().UnregisterSite_(this);
+}
+
+bool LogSiteGate::Bind_(const Logger* p_pLogger) noexcept {
+	return LogManager::GetInstance().BindSite_(this, p_pLogger);
+}
+
+LogRateLimiter::LogRateLimiter(LPCTSTR p_cszFuncName, double p_dRatePerSecond, size_t p_nBurst, size_t p_nSampleEvery)
+    : m_cszFuncName_(p_cszFuncName)
+    , m_nInterval_(0)
+    , m_nTolerance_(0)
+    , m_nSampleEvery_(p_nSampleEvery) {
+	if (p_dRatePerSecond > 0) {
+		using SteadyClock = std::chrono::steady_clock;
+		const double dTicksPerSecond = static_cast<double>(SteadyClock::period::den) / SteadyClock::period::num;
+
+		m_nInterval_  = std::max<int64_t>(1, static_cast<int64_t>(dTicksPerSecond / p_dRatePerSecond));
+		m_nTolerance_ = m_nInterval_ * static_cast<int64_t>(std::max<size_t>(p_nBurst, 1) - 1);
+	}
+
+	LogManager::GetInstance().RegisterLimiter_(this);
+}
+
+LogRateLimiter::~LogRateLimiter() {
+	LogManager::GetInstance().UnregisterLimiter_(this);
+}
+
+bool LogRateLimiter::TryAcquire(size_t& p_nSuppressed) noexcept {
+	if (m_nSampleEvery_ > 1 && m_nCalls_.fetch_add(1, std::memory_order_relaxed) % m_nSampleEvery_ != 0) {
+		m_nSuppressed_.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	if (m_nInterval_ != 0) {
+		const int64_t nNow = std::chrono::steady_clock::now().time_since_epoch().count();
+
+		// 理论到达时间超前当前时间超过容差时，桶中已无令牌
+		int64_t nTat = m_nTat_.load(std::memory_order_relaxed);
+		int64_t nNewTat;
+		do {
+			const int64_t nBase = std::max(nTat, nNow);
+			if (nBase - nNow > m_nTolerance_) {
+				m_nSuppressed_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			nNewTat = nBase + m_nInterval_;
+		} while (!m_nTat_.compare_exchange_weak(nTat, nNewTat, std::memory_order_relaxed));
+	}
+
+	p_nSuppressed = m_nSuppressed_.load(std::memory_order_relaxed) != 0 ? m_nSuppressed_.exchange(0, std::memory_order_relaxed) : 0;
+	return true;
+}
+
+bool LogRateLimiter::MarkPending_(const Logger* p_pLogger, LogLevel p_level) noexcept {
+	// 抑制期间每次调用都会到达这里，只在值变化时写入，避免各核心争抢同一缓存行
+	if (m_pLogger_.load(std::memory_order_relaxed) != p_pLogger) {
+		m_pLogger_.store(p_pLogger, std::memory_order_relaxed);
+	}
+	if (m_level_.load(std::memory_order_relaxed) != p_level) {
+		m_level_.store(p_level, std::memory_order_relaxed);
+	}
+
+	// 只有一段抑制的第一次调用需要安排汇总
+	return !m_bPending_.load(std::memory_order_relaxed) && !m_bPending_.exchange(true, std::memory_order_relaxed);
+}
+
+std::chrono::steady_clock::duration LogRateLimiter::GetWindow_() const noexcept {
+	// 令牌桶从空到满所需的时间；只采样不限速时按 1 秒汇总
+	if (m_nInterval_ == 0) {
+		return Seconds(1);
+	}
+	return std::chrono::steady_clock::duration(m_nInterval_ + m_nTolerance_);
+}
+
 Logger::Logger(const String& pc_strName, const String& pc_strFilePath_, _UTILS LogLevel p_level)
     : m_strName_(pc_strName)
     , m_logLevel_(p_level) {
+#ifdef _DEBUG
+	this->AddSink(std::make_shared<DebugOutputLogSink>());
+#endif // DEBUG
+
 	if (!pc_strFilePath_.empty()) {
 		m_strLogFilePath_ = pc_strFilePath_;
-		return;
+	} else {
+		std::filesystem::path strFilePath = std::filesystem::current_path();
+		strFilePath /= TEXT("logs\\");
+		m_strLogFilePath_ = strFilePath.native();
 	}
 
-	std::filesystem::path strFilePath = std::filesystem::current_path();
-	strFilePath /= TEXT("logs\\");
-	m_strLogFilePath_ = strFilePath.native();
+	// 配置文件中指定的级别优先于构造时给定的级别
+	LogManager::GetInstance().Register_(this);
 }
 
 Logger::~Logger() {
+	LogManager::GetInstance().Unregister_(this);
+	LogManager::GetInstance().UnbindSites_(this);
+
+	// 维护线程也会写入汇总记录，需在写入线程之前停止
+	if (m_thMaintainer_.joinable()) {
+		{
+			std::lock_guard<std::mutex> guard(m_mtxMaintain_);
+			m_bStopMaintain_ = true;
+		}
+		m_cvMaintain_.notify_one();
+		m_thMaintainer_.join();
+	}
+
+	LogManager::GetInstance().FlushSuppressed_(this);
+	LogManager::GetInstance().UnbindLimiters_(this);
+
+	if (m_thWriter_.joinable()) {
+		m_bStopping_.store(true, std::memory_order_release);
+		m_bWriterIdle_.store(false, std::memory_order_release);
+		m_bWriterIdle_.notify_one();
+		m_thWriter_.join();
+	}
+
+	if (m_pShared_) {
+		std::lock_guard<std::mutex> guard(m_pShared_->mtxWrite);
+		if (m_pShared_->durability != LogDurability::NONE) {
+			this->SyncFile_();
+		}
+	}
 }
 
-void Logger::Log_(const TCHAR* p_cszFuncName, const String& pc_strType, const String& pc_strMsg) const {
-	std::basic_ofstream<String::value_type> ofs;
-	ofs.imbue(std::locale("", std::locale::all ^ std::locale::numeric));
+StringView Logger::TrimMessage_(StringView p_svMsg) noexcept {
+	return StringUtils::TrimView(p_svMsg);
+}
+
+std::string& Logger::GetPayloadBuffer_() noexcept {
+	thread_local std::string t_strPayload;
+	return t_strPayload;
+}
+
+void Logger::Log_(const TCHAR* p_cszFuncName, _UTILS LogLevel p_level, StringView p_svMsg, std::span<const LogField> p_fields) const {
 	const DateTime dtNow = DateTimeUtils::Now();
+	if (m_pRecorder_) {
+		m_pRecorder_->Record(dtNow, p_level, p_cszFuncName, TrimMessage_(p_svMsg));
+	}
 
-	auto strFileName = std::filesystem::path(m_strLogFilePath_);
-	if (!std::filesystem::exists(strFileName)) {
+	const bool bError = p_level == LogLevel::ERR;
+
+	if (m_pQueue_) {
+		LogRecord record { dtNow, p_level, p_cszFuncName };
+		if (p_fields.empty()) {
+			record.strMsg.assign(p_svMsg);
+		} else {
+			// 字段仅在调用期间有效，需在调用线程中生成最终字节
+			this->AppendMessage_(record.strPayload, dtNow, p_level, p_cszFuncName, p_svMsg, p_fields);
+			record.bRaw = true;
+		}
+
+		this->Enqueue_(std::move(record));
+		// 只等待写入线程写完并落盘，不刷新输出目标，后者可能因网络等原因长时间阻塞
+		if (bError && this->GetFileDurability_() != LogDurability::NONE) {
+			this->WaitWritten_();
+		}
+		return;
+	}
+
+	SharedLogFile& file = this->GetSharedFile_();
+
+	thread_local std::string t_strBytes;
+	t_strBytes.clear();
+
+	uint64_t nTicket = 0;
+	if (!m_bBinaryMode_) {
+		this->AppendMessage_(t_strBytes, dtNow, p_level, p_cszFuncName, p_svMsg, p_fields);
+
+		std::lock_guard<std::mutex> guard(file.mtxWrite);
+		nTicket = this->WriteBytes_(t_strBytes, dtNow, 1, bError);
+	} else {
+		std::lock_guard<std::mutex> guard(file.mtxWrite);
+		if (this->EnsureFile_(dtNow)) {
+			this->AppendMessage_(t_strBytes, dtNow, p_level, p_cszFuncName, p_svMsg, p_fields);
+			nTicket = this->WriteBytes_(t_strBytes, dtNow, 1, bError);
+		}
+	}
+	this->Commit_(nTicket);
+}
+
+void Logger::LogFields(
+    _UTILS LogLevel p_level, const TCHAR* p_cszFuncName, StringView p_svMsg, std::initializer_list<LogField> p_fields) const noexcept {
+	if (!this->IsLevelEnabled_(p_level)) {
+		if (m_pRecorder_) {
+			m_pRecorder_->Record(DateTimeUtils::Now(), p_level, p_cszFuncName, TrimMessage_(p_svMsg));
+		}
+		return;
+	}
+
+	this->Log_(p_cszFuncName, p_level, p_svMsg, std::span<const LogField>(p_fields.begin(), p_fields.size()));
+}
+
+void Logger::LogSuppressed_(_UTILS LogLevel p_level, const TCHAR* p_cszFuncName, size_t p_nSuppressed) const {
+	this->Log_(p_cszFuncName, p_level, FORMAT("suppressed {} messages from {}", p_nSuppressed, p_cszFuncName ? p_cszFuncName : TEXT("")));
+}
+
+void Logger::LogFormat_(
+    const TCHAR* p_cszFuncName, _UTILS LogLevel p_level, StringView p_svFmt, std::basic_format_args<FormatContext_> p_args) const {
+	if (!this->IsLevelEnabled_(p_level)) {
+		if (m_pRecorder_) {
+			this->RecordFormat_(p_cszFuncName, p_level, p_svFmt, p_args);
+		}
+		return;
+	}
+
+	thread_local String t_strMsg;
+	t_strMsg.clear();
+	std::vformat_to(std::back_inserter(t_strMsg), p_svFmt, p_args);
+
+	this->Log_(p_cszFuncName, p_level, t_strMsg);
+}
+
+void Logger::RecordFormat_(
+    const TCHAR* p_cszFuncName, _UTILS LogLevel p_level, StringView p_svFmt, std::basic_format_args<FormatContext_> p_args) const {
+	thread_local String t_strMsg;
+	t_strMsg.clear();
+	std::vformat_to(std::back_inserter(t_strMsg), p_svFmt, p_args);
+
+	m_pRecorder_->Record(DateTimeUtils::Now(), p_level, p_cszFuncName, TrimMessage_(t_strMsg));
+}
+
+void Logger::LogBinary_(_UTILS LogLevel p_level, const LogCallSite& pc_site, const std::string& pc_strPayload) const {
+	const DateTime dtNow = DateTimeUtils::Now();
+
+	const bool bError = p_level == LogLevel::ERR;
+
+	if (m_pQueue_) {
+		this->Enqueue_(LogRecord { dtNow, p_level, pc_site.GetFuncName(), String(), &pc_site, pc_strPayload });
+		if (bError && this->GetFileDurability_() != LogDurability::NONE) {
+			this->WaitWritten_();
+		}
+		return;
+	}
+
+	SharedLogFile& file = this->GetSharedFile_();
+
+	thread_local std::string t_strBytes;
+	t_strBytes.clear();
+
+	uint64_t nTicket = 0;
+	{
+		std::lock_guard<std::mutex> guard(file.mtxWrite);
+		if (this->EnsureFile_(dtNow)) {
+			this->AppendSiteRecord_(t_strBytes, dtNow, p_level, pc_site, pc_strPayload);
+			nTicket = this->WriteBytes_(t_strBytes, dtNow, 1, bError);
+		}
+	}
+	this->Commit_(nTicket);
+}
+
+void Logger::FormatLine(String& p_strOut, const DateTime& pc_dtTime, _UTILS LogLevel p_level, const TCHAR* p_cszFuncName, StringView p_svMsg) {
+	AppendTimestamp(p_strOut, pc_dtTime);
+	p_strOut.append(TEXT("] ["));
+	p_strOut.append(GetPaddedLevelName(p_level));
+	p_strOut.append(TEXT("]  "));
+	if (p_cszFuncName) {
+		p_strOut.append(p_cszFuncName);
+	}
+	p_strOut.append(TEXT(": "));
+	p_strOut.append(TrimMessage_(p_svMsg));
+	p_strOut.push_back(TEXT('\n'));
+}
+
+void Logger::AppendMessage_(std::string& p_strBytes, const DateTime& pc_dtTime, _UTILS LogLevel p_level, const TCHAR* p_cszFuncName,
+    StringView p_svMsg, std::span<const LogField> p_fields) const {
+	const bool bHasSinks = m_bHasSinks_.load(std::memory_order_acquire);
+	const bool bJson     = m_bJsonLines_ && !m_bBinaryMode_;
+
+	// 非 JSON 格式下字段以 key=value 附加在消息之后
+	thread_local String t_strFieldsMsg;
+	if (!p_fields.empty() && !bJson) {
+		t_strFieldsMsg.assign(TrimMessage_(p_svMsg));
+		AppendFieldsText(t_strFieldsMsg, p_fields);
+		p_svMsg = t_strFieldsMsg;
+	}
+
+	const size_t nOffset = p_strBytes.size();
+	if (m_bBinaryMode_) {
+		const StringView svFuncName = p_cszFuncName ? StringView(p_cszFuncName) : StringView();
+		AppendRaw_(p_strBytes, LogBinaryFormat::Entry::MESSAGE);
+		AppendRaw_(p_strBytes, static_cast<int64_t>(pc_dtTime.time_since_epoch().count()));
+		AppendRaw_(p_strBytes, static_cast<uint8_t>(p_level));
+		AppendRaw_(p_strBytes, static_cast<uint16_t>(svFuncName.size()));
+		p_strBytes.append(reinterpret_cast<const char*>(svFuncName.data()), svFuncName.size() * sizeof(TCHAR));
+		AppendRawString_(p_strBytes, TrimMessage_(p_svMsg));
+		if (!bHasSinks) {
+			return;
+		}
+	} else if (bJson) {
+		AppendJsonLine(p_strBytes, pc_dtTime, p_level, p_cszFuncName, TrimMessage_(p_svMsg), p_fields);
+		if (!bHasSinks) {
+			return;
+		}
+	}
+
+	thread_local String t_strLine;
+	t_strLine.clear();
+	FormatLine(t_strLine, pc_dtTime, p_level, p_cszFuncName, p_svMsg);
+
+	std::string_view svBytes;
+	if (m_bBinaryMode_) {
+		// 二进制模式下文本仅供输出目标使用，不写入文件
+		thread_local std::string t_strText;
+		t_strText.clear();
+		AppendText(t_strText, t_strLine);
+		svBytes = t_strText;
+	} else {
+		if (!bJson) {
+			AppendText(p_strBytes, t_strLine);
+		}
+		svBytes = std::string_view(p_strBytes).substr(nOffset);
+	}
+
+	if (bHasSinks) {
+		this->DispatchToSinks_(LogSinkRecord { pc_dtTime, p_level, p_cszFuncName, TrimMessage_(p_svMsg), t_strLine, svBytes });
+	}
+}
+
+void Logger::DispatchToSinks_(const LogSinkRecord& pc_record) const {
+	std::shared_lock<std::shared_mutex> lock(m_mtxSinks_);
+	for (const auto& pSink : m_vSinks_) {
+		if (!pSink->Accepts(pc_record.level)) {
+			continue;
+		}
+
+		// 单个输出目标的异常不影响其他目标与日志文件
 		try {
-			std::filesystem::create_directories(strFileName);
+			pSink->Write(pc_record);
 		} catch (const std::exception&) {
+		}
+	}
+}
+
+void Logger::AddSink(std::shared_ptr<LogSink> p_pSink) {
+	if (!p_pSink) {
+		throw NullPointerReferenceException(TEXT("p_pSink"));
+	}
+
+	std::unique_lock<std::shared_mutex> lock(m_mtxSinks_);
+	m_vSinks_.push_back(std::move(p_pSink));
+	m_bHasSinks_.store(true, std::memory_order_release);
+}
+
+void Logger::RemoveSink(const std::shared_ptr<LogSink>& pc_pSink) {
+	std::unique_lock<std::shared_mutex> lock(m_mtxSinks_);
+	std::erase(m_vSinks_, pc_pSink);
+	m_bHasSinks_.store(!m_vSinks_.empty(), std::memory_order_release);
+}
+
+void Logger::AppendSiteRecord_(
+    std::string& p_strBytes, const DateTime& pc_dtTime, _UTILS LogLevel p_level, const LogCallSite& pc_site, const std::string& pc_strPayload) const {
+	SharedLogFile& file = this->GetSharedFile_();
+
+	const uint32_t nSiteId = pc_site.GetId();
+	if (nSiteId >= file.vbSitesWritten.size()) {
+		file.vbSitesWritten.resize(nSiteId + 1, false);
+	}
+
+	// 调用点定义在每个文件中首次用到时写入一次，保证每个文件都可以独立解码
+	if (!file.vbSitesWritten[nSiteId]) {
+		file.vbSitesWritten[nSiteId] = true;
+
+		const StringView svFuncName = pc_site.GetFuncName();
+		const StringView svFormat   = pc_site.GetFormat();
+		AppendRaw_(p_strBytes, LogBinaryFormat::Entry::SITE);
+		AppendRaw_(p_strBytes, nSiteId);
+		AppendRaw_(p_strBytes, static_cast<uint16_t>(svFuncName.size()));
+		p_strBytes.append(reinterpret_cast<const char*>(svFuncName.data()), svFuncName.size() * sizeof(TCHAR));
+		AppendRaw_(p_strBytes, static_cast<uint16_t>(svFormat.size()));
+		p_strBytes.append(reinterpret_cast<const char*>(svFormat.data()), svFormat.size() * sizeof(TCHAR));
+	}
+
+	AppendRaw_(p_strBytes, LogBinaryFormat::Entry::RECORD);
+	AppendRaw_(p_strBytes, nSiteId);
+	AppendRaw_(p_strBytes, static_cast<int64_t>(pc_dtTime.time_since_epoch().count()));
+	AppendRaw_(p_strBytes, static_cast<uint8_t>(p_level));
+	AppendRaw_(p_strBytes, static_cast<uint32_t>(pc_strPayload.size()));
+	p_strBytes.append(pc_strPayload);
+}
+
+void Logger::AppendRecord_(std::string& p_strBytes, const LogRecord& pc_record) const {
+	if (pc_record.bRaw) {
+		p_strBytes.append(pc_record.strPayload);
+	} else if (pc_record.pSite && m_bBinaryMode_) {
+		this->AppendSiteRecord_(p_strBytes, pc_record.dtTime, pc_record.level, *pc_record.pSite, pc_record.strPayload);
+	} else {
+		this->AppendMessage_(p_strBytes, pc_record.dtTime, pc_record.level, pc_record.pcszFuncName, pc_record.strMsg);
+	}
+}
+
+String Logger::BuildFilePath_(const DateTime& pc_dtTime, size_t p_nSegment) const {
+	auto strFileName = std::filesystem::path(m_strLogFilePath_);
+	if (p_nSegment == 0) {
+		strFileName /= FORMAT("{}-{:%Y%m%d}.{}", m_strName_, pc_dtTime, this->GetFileExtension_());
+	} else {
+		strFileName /= FORMAT("{}-{:%Y%m%d}.{}.{}", m_strName_, pc_dtTime, p_nSegment, this->GetFileExtension_());
+	}
+
+	return strFileName.native();
+}
+
+size_t Logger::FindLastSegment_(const DateTime& pc_dtTime) const {
+	const String strPrefix = FORMAT("{}-{:%Y%m%d}.", m_strName_, pc_dtTime);
+
+	size_t nLastSegment = 0;
+	bool bFound = false, bLastIsLog = false;
+
+	std::error_code ec;
+	for (const auto& entry : std::filesystem::directory_iterator(m_strLogFilePath_, ec)) {
+		const String strFileName = entry.path().filename().native();
+
+		size_t nSegment;
+		bool bCompressed;
+		if (!strFileName.starts_with(strPrefix) || !ParseSegment(strFileName, strPrefix.size(), this->GetFileExtension_(), nSegment, bCompressed)) {
+			continue;
+		}
+
+		if (!bFound || nSegment > nLastSegment) {
+			bFound       = true;
+			nLastSegment = nSegment;
+			bLastIsLog   = !bCompressed;
+		} else if (nSegment == nLastSegment) {
+			bLastIsLog |= !bCompressed;
+		}
+	}
+
+	// 最后一个分段已被压缩时不能再追加，从下一个分段开始
+	return bFound && !bLastIsLog ? nLastSegment + 1 : nLastSegment;
+}
+
+bool Logger::OpenFile_(const DateTime& pc_dtTime, size_t p_nSegment) const {
+	SharedLogFile& file = this->GetSharedFile_();
+
+	// 首个打开文件的 Logger 决定文件相关的设置，之后只读取 file 中的快照
+	if (!file.pWriter) {
+		file.bMappedFile      = m_bMappedFile_;
+		file.durability       = m_durability_;
+		file.nSyncEveryN      = m_nSyncEveryN_;
+		file.nSyncIntervalMs  = m_nSyncIntervalMs_;
+		file.nIndexInterval   = m_bBinaryMode_ ? 0 : m_nIndexInterval_;
+		file.nMaxFileSize     = m_nMaxFileSize_;
+		file.nMaxFileCount    = m_nMaxFileCount_;
+		file.nMaxTotalSize    = m_nMaxTotalSize_;
+		file.bCompressRotated = m_bCompressRotated_;
+
+		file.pWriter = file.bMappedFile ? std::unique_ptr<LogFileWriter>(std::make_unique<MappedLogFileWriter>(
+		                                      MappedLogFileWriter::DEFAULT_CHUNK_SIZE, &LogBinaryFormat::FindValidLength))
+		                               : std::unique_ptr<LogFileWriter>(std::make_unique<BufferedLogFileWriter>());
+	}
+
+	// 切换文件前先让旧文件中尚未落盘的记录落盘
+	if (file.durability != LogDurability::NONE && file.pWriter->IsOpen() && file.nUnsynced != 0) {
+		this->SyncFile_();
+	}
+	file.pWriter->Close();
+	if (file.pIndex) {
+		file.pIndex->Close();
+	}
+
+	std::error_code ec;
+	std::filesystem::create_directories(std::filesystem::path(m_strLogFilePath_), ec);
+	if (ec) {
+		return false;
+	}
+
+	String strFileName = this->BuildFilePath_(pc_dtTime, p_nSegment);
+	if (!file.pWriter->Open(strFileName, m_bBinaryMode_)) {
+		return false;
+	}
+
+	if (m_bBinaryMode_) {
+		file.vbSitesWritten.assign(file.vbSitesWritten.size(), false);
+		if (file.pWriter->GetSize() == 0) {
+			const uint32_t nCharSize       = sizeof(TCHAR);
+			const int64_t nTicksPerSecond = Clock::period::den / Clock::period::num;
+
+			std::string strHeader(LogBinaryFormat::MAGIC, sizeof(LogBinaryFormat::MAGIC));
+			AppendRaw_(strHeader, nCharSize);
+			AppendRaw_(strHeader, nTicksPerSecond);
+			file.pWriter->Write(strHeader.data(), strHeader.size());
+		}
+	} else if (file.bFirstLog && file.pWriter->GetSize() != 0) {
+		file.pWriter->Write("\n", 1);
+	}
+	file.bFirstLog = false;
+
+	if (file.nIndexInterval != 0) {
+		this->OpenIndex_(strFileName);
+	}
+
+	file.strFullFilePath = std::move(strFileName);
+	file.dtNextMidnight  = std::chrono::floor<Days>(pc_dtTime) + Days(1);
+	file.nSegment        = p_nSegment;
+	return true;
+}
+
+void Logger::OpenIndex_(const String& pc_strFilePath) const {
+	SharedLogFile& file = this->GetSharedFile_();
+
+	if (!file.pIndex) {
+		file.pIndex = std::make_unique<BufferedLogFileWriter>();
+	}
+	file.nUnindexed = 0;
+	if (!file.pIndex->Open(pc_strFilePath + LogIndexFormat::FILE_EXTENSION, true) || file.pIndex->GetSize() != 0) {
+		return;
+	}
+
+	const int64_t nTicksPerSecond = Clock::period::den / Clock::period::num;
+
+	std::string strHeader(LogIndexFormat::MAGIC, sizeof(LogIndexFormat::MAGIC));
+	AppendRaw_(strHeader, nTicksPerSecond);
+	file.pIndex->Write(strHeader.data(), strHeader.size());
+}
+
+bool Logger::EnsureFile_(const DateTime& pc_dtTime) const {
+	SharedLogFile& file = this->GetSharedFile_();
+
+	const bool bOpened = file.pWriter && file.pWriter->IsOpen();
+	if (bOpened && pc_dtTime < file.dtNextMidnight) {
+		return true;
+	}
+
+	String strOldPath = file.strFullFilePath;
+	if (!this->OpenFile_(pc_dtTime, this->FindLastSegment_(pc_dtTime))) {
+		return false;
+	}
+	if (bOpened) {
+		this->QueueRotated_(std::move(strOldPath));
+	}
+	return true;
+}
+
+uint64_t Logger::WriteBytes_(const std::string& pc_strBytes, const DateTime& pc_dtTime, size_t p_nRecords, bool p_bError) const {
+	SharedLogFile& file = this->GetSharedFile_();
+
+	if (!this->EnsureFile_(pc_dtTime)) {
+		return 0;
+	}
+
+	const uint64_t nOffset = file.pWriter->GetSize();
+	file.pWriter->Write(pc_strBytes.data(), pc_strBytes.size());
+	file.nWritten += p_nRecords;
+
+	// 每 IndexInterval 条记录登记一次，以本次写入的第一条记录为准
+	if (file.pIndex && file.pIndex->IsOpen()) {
+		if (file.nUnindexed == 0) {
+			const LogIndexFormat::Entry entry { pc_dtTime.time_since_epoch().count(), nOffset };
+			file.pIndex->Write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+			file.pIndex->Flush();
+		}
+		file.nUnindexed += p_nRecords;
+		if (file.nUnindexed >= file.nIndexInterval) {
+			file.nUnindexed = 0;
+		}
+	}
+
+	// 需要落盘时由落盘操作一并写出，避免多一次系统调用
+	const bool bSync = this->IsSyncDue_(p_nRecords, p_bError);
+	if (!bSync) {
+		file.pWriter->Flush();
+	}
+
+	if (file.nMaxFileSize != 0 && file.pWriter->GetSize() >= file.nMaxFileSize) {
+		String strOldPath = file.strFullFilePath;
+		if (this->OpenFile_(pc_dtTime, file.nSegment + 1)) {
+			this->QueueRotated_(std::move(strOldPath));
+		}
+	}
+	return bSync ? file.nWritten : 0;
+}
+
+bool Logger::IsSyncDue_(size_t p_nRecords, bool p_bError) const {
+	SharedLogFile& file = this->GetSharedFile_();
+
+	file.nUnsynced += p_nRecords;
+
+	switch (file.durability) {
+		case LogDurability::FLUSH_EVERY_N:
+			return p_bError || file.nUnsynced >= file.nSyncEveryN;
+		case LogDurability::FLUSH_EVERY_MS:
+			return p_bError || std::chrono::steady_clock::now() - file.tpLastSync >= std::chrono::milliseconds(file.nSyncIntervalMs);
+		case LogDurability::SYNC_ON_ERROR:
+			return p_bError;
+		default:
+			return false;
+	}
+}
+
+LogDurability Logger::GetFileDurability_() const {
+	SharedLogFile& file = this->GetSharedFile_();
+
+	// 与同步模式相同，以文件的快照为准；文件尚未被任何 Logger 打开时，将由写入线程按本 Logger 的设置打开
+	std::lock_guard<std::mutex> guard(file.mtxWrite);
+	return file.pWriter ? file.durability : m_durability_;
+}
+
+void Logger::SyncFile_() const noexcept {
+	SharedLogFile& file = this->GetSharedFile_();
+
+	if (file.pWriter && file.pWriter->IsOpen()) {
+		file.pWriter->Sync();
+	}
+	file.nUnsynced  = 0;
+	file.tpLastSync = std::chrono::steady_clock::now();
+}
+
+void Logger::Commit_(uint64_t p_nTicket) const {
+	if (p_nTicket == 0) {
+		return;
+	}
+
+	SharedLogFile& file = this->GetSharedFile_();
+
+	std::unique_lock<std::mutex> lock(file.mtxCommit);
+	while (file.nCommitted < p_nTicket) {
+		if (file.bCommitting) {
+			file.cvCommit.wait(lock);
+			continue;
+		}
+
+		// 由当前线程执行本轮落盘，一次落盘即可覆盖此前所有线程已写入的记录
+		file.bCommitting = true;
+		lock.unlock();
+
+		uint64_t nWritten;
+		{
+			std::lock_guard<std::mutex> guard(file.mtxWrite);
+			this->SyncFile_();
+			nWritten = file.nWritten;
+		}
+
+		lock.lock();
+		file.nCommitted  = std::max(file.nCommitted, nWritten);
+		file.bCommitting = false;
+		file.cvCommit.notify_all();
+	}
+}
+
+void Logger::QueueRotated_(String&& p_strFilePath) const {
+	// 在写入锁内由执行切换的 Logger 调用，每个被切换的文件只会加入一次
+	const SharedLogFile& file = this->GetSharedFile_();
+	if (!file.bCompressRotated && file.nMaxFileCount == 0 && file.nMaxTotalSize == 0) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(m_mtxMaintain_);
+		m_dqRotatedFiles_.push_back(std::move(p_strFilePath));
+		if (!m_thMaintainer_.joinable()) {
+			m_thMaintainer_ = std::thread(&Logger::MaintainLoop_, this);
+		}
+	}
+	m_cvMaintain_.notify_one();
+}
+
+void Logger::ScheduleSuppressed_(std::chrono::steady_clock::duration p_window) const {
+	{
+		std::lock_guard<std::mutex> guard(m_mtxMaintain_);
+		if (m_bStopMaintain_) {
 			return;
 		}
+		m_tpSuppressedDue_ = std::min(m_tpSuppressedDue_, std::chrono::steady_clock::now() + p_window);
+		if (!m_thMaintainer_.joinable()) {
+			m_thMaintainer_ = std::thread(&Logger::MaintainLoop_, this);
+		}
 	}
+	m_cvMaintain_.notify_one();
+}
 
-	strFileName /= FORMAT("{}-{:%Y%m%d}.log", m_strName_, dtNow);
-	bool bExists = std::filesystem::exists(strFileName);
-	ofs.open(strFileName, std::ios::app);
+void Logger::MaintainLoop_() const {
+	// 汇总记录经共享的写入锁写入文件，以正常优先级执行；只有压缩与保留策略在后台模式下执行
+	for (;;) {
+		String strFilePath;
+		bool bSuppressedDue = false;
+		{
+			// 汇总时间可能在等待期间被提前，每次唤醒后重新计算
+			std::unique_lock<std::mutex> lock(m_mtxMaintain_);
+			while (!m_bStopMaintain_ && m_dqRotatedFiles_.empty()) {
+				if (m_tpSuppressedDue_ <= std::chrono::steady_clock::now()) {
+					m_tpSuppressedDue_ = std::chrono::steady_clock::time_point::max();
+					bSuppressedDue     = true;
+					break;
+				}
+				if (m_tpSuppressedDue_ == std::chrono::steady_clock::time_point::max()) {
+					m_cvMaintain_.wait(lock);
+				} else {
+					m_cvMaintain_.wait_until(lock, m_tpSuppressedDue_);
+				}
+			}
+			if (!bSuppressedDue) {
+				if (m_dqRotatedFiles_.empty()) {
+					return;
+				}
+				strFilePath = std::move(m_dqRotatedFiles_.front());
+				m_dqRotatedFiles_.pop_front();
+			}
+		}
 
-	if (!ofs.is_open()) {
+		if (bSuppressedDue) {
+			try {
+				LogManager::GetInstance().FlushSuppressed_(this);
+			} catch (const std::exception&) {
+			}
+			continue;
+		}
+
+		try {
+			SharedLogFile& file = this->GetSharedFile_();
+			bool bCompress;
+			{
+				std::lock_guard<std::mutex> guard(file.mtxWrite);
+				bCompress = file.bCompressRotated;
+			}
+
+			if (bCompress) {
+				BackgroundModeScope background;
+				const String strPackedPath = strFilePath + CompressionUtils::FILE_EXTENSION;
+				std::error_code ec;
+				if (CompressionUtils::CompressFile(strFilePath, strPackedPath)) {
+					std::filesystem::remove(strFilePath, ec);
+				} else {
+					std::filesystem::remove(strPackedPath, ec);
+				}
+			}
+
+			this->ApplyRetention_();
+		} catch (const std::exception&) {
+		}
+	}
+}
+
+void Logger::ApplyRetention_() const {
+	SharedLogFile& file = this->GetSharedFile_();
+
+	String strActivePath;
+	size_t nMaxFileCount;
+	size_t nMaxTotalSize;
+	{
+		std::lock_guard<std::mutex> guard(file.mtxWrite);
+		strActivePath = file.strFullFilePath;
+		nMaxFileCount = file.nMaxFileCount;
+		nMaxTotalSize = file.nMaxTotalSize;
+	}
+	if (nMaxFileCount == 0 && nMaxTotalSize == 0) {
 		return;
 	}
 
-	String strLine;
-	if (m_bFirstLog_) {
-		m_bFirstLog_ = false;
-		if (bExists) {
-			strLine = TEXT("\n");
-			ofs.write(strLine.c_str(), strLine.size());
+	BackgroundModeScope background;
+
+	struct LogFileEntry {
+		String strDate;
+		size_t nSegment;
+		std::filesystem::path path;
+		uintmax_t nSize;
+		bool bCompressed;
+	};
+
+	const String strPrefix = m_strName_ + TEXT("-");
+	std::vector<LogFileEntry> vFiles;
+
+	std::error_code ec;
+	for (const auto& entry : std::filesystem::directory_iterator(m_strLogFilePath_, ec)) {
+		const String strFileName = entry.path().filename().native();
+		const size_t nDateEnd    = strPrefix.size() + 8;
+		if (!strFileName.starts_with(strPrefix) || strFileName.size() <= nDateEnd || strFileName[nDateEnd] != TEXT('.')
+		    || !std::all_of(strFileName.begin() + strPrefix.size(), strFileName.begin() + nDateEnd, [](TCHAR ch) { return TEXT('0') <= ch && ch <= TEXT('9'); })) {
+			continue;
 		}
+
+		size_t nSegment;
+		bool bCompressed;
+		if (!ParseSegment(strFileName, nDateEnd + 1, this->GetFileExtension_(), nSegment, bCompressed)) {
+			continue;
+		}
+
+		std::error_code ecSize;
+		const uintmax_t nSize = entry.file_size(ecSize);
+		vFiles.push_back({ strFileName.substr(strPrefix.size(), 8), nSegment, entry.path(), ecSize ? 0 : nSize, bCompressed });
 	}
 
-	strLine = FORMAT("[{:%Y-%m-%d %H:%M:%OS}.{:03d}] [{:5}]  {}: {}\n", dtNow,
-	    std::chrono::duration_cast<MilliSeconds>(dtNow.time_since_epoch()).count() % 1000, pc_strType, p_cszFuncName, StringUtils::Trim(pc_strMsg));
+	// 由新到旧排列，当前文件始终保留
+	std::sort(vFiles.begin(), vFiles.end(), [](const LogFileEntry& pc_left, const LogFileEntry& pc_right) {
+		return pc_left.strDate != pc_right.strDate ? pc_left.strDate > pc_right.strDate : pc_left.nSegment > pc_right.nSegment;
+	});
 
-#ifdef _DEBUG
-	::OutputDebugString(strLine.c_str());
-#endif // DEBUG
+	size_t nCount    = 0;
+	uintmax_t nTotal = 0;
+	for (const auto& file : vFiles) {
+		const bool bActive = file.path.native() == strActivePath;
+		++nCount;
+		nTotal += file.nSize;
+
+		if (bActive) {
+			continue;
+		}
+
+		if ((nMaxFileCount != 0 && nCount > nMaxFileCount) || (nMaxTotalSize != 0 && nTotal > nMaxTotalSize)) {
+			std::filesystem::remove(file.path, ec);
+			if (!file.bCompressed) {
+				std::filesystem::path pathIndex = file.path;
+				std::filesystem::remove(pathIndex += LogIndexFormat::FILE_EXTENSION, ec);
+			}
+			--nCount;
+			nTotal -= file.nSize;
+		}
+	}
+}
+
+void Logger::Enqueue_(LogRecord&& p_record) const {
+	switch (m_overflowPolicy_) {
+		case LogOverflowPolicy::BLOCK:
+			while (!m_pQueue_->TryPush(std::move(p_record))) {
+				this->WakeWriter_();
+				std::this_thread::yield();
+			}
+			break;
+		case LogOverflowPolicy::DROP_NEWEST:
+			if (!m_pQueue_->TryPush(std::move(p_record))) {
+				m_nDropped_.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			break;
+		case LogOverflowPolicy::DROP_OLDEST: {
+			size_t nFailedPops = 0;
+			while (!m_pQueue_->TryPush(std::move(p_record))) {
+				LogRecord recOldest;
+				if (m_pQueue_->TryPop(recOldest)) {
+					m_nDropped_.fetch_add(1, std::memory_order_relaxed);
+					m_nProcessed_.fetch_add(1, std::memory_order_release);
+					m_nProcessed_.notify_all();
+					continue;
+				}
+
+				// 队头的格被其他线程占用时让出时间片，而不是空转争抢；始终取不出时改为丢弃本条
+				if (++nFailedPops > MAX_DROP_OLDEST_RETRIES) {
+					m_nDropped_.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				std::this_thread::yield();
+			}
+			break;
+		}
+	}
+
+	this->WakeWriter_();
+}
+
+void Logger::WakeWriter_() const noexcept {
+	// 与写线程进入休眠前的检查配对，保证不会遗漏刚发布的记录
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_bWriterIdle_.load(std::memory_order_relaxed) && m_bWriterIdle_.exchange(false, std::memory_order_acq_rel)) {
+		m_bWriterIdle_.notify_one();
+	}
+}
+
+void Logger::WriterLoop_() {
+	SharedLogFile& file = this->GetSharedFile_();
+
+	std::vector<LogRecord> vRecords;
+	vRecords.reserve(WRITER_BATCH_SIZE);
+	std::string strBytes;
+
+	for (;;) {
+		LogRecord record;
+		while (vRecords.size() < WRITER_BATCH_SIZE && m_pQueue_->TryPop(record)) {
+			vRecords.push_back(std::move(record));
+		}
+
+		if (!vRecords.empty()) {
+			try {
+				std::lock_guard<std::mutex> guard(file.mtxWrite);
+
+				// 跨越零点的批次按日期拆分写入，保证记录落入各自日期的文件
+				size_t idxChunk = 0;
+				while (idxChunk < vRecords.size()) {
+					const DateTime dtChunk    = vRecords[idxChunk].dtTime;
+					const DateTime dtChunkEnd = std::chrono::floor<Days>(dtChunk) + Days(1);
+
+					const bool bOpened = this->EnsureFile_(dtChunk);
+
+					strBytes.clear();
+					const size_t idxBegin = idxChunk;
+					bool bError           = false;
+					for (; idxChunk < vRecords.size() && vRecords[idxChunk].dtTime < dtChunkEnd; ++idxChunk) {
+						bError |= vRecords[idxChunk].level == LogLevel::ERR;
+						if (bOpened) {
+							this->AppendRecord_(strBytes, vRecords[idxChunk]);
+						}
+					}
+
+					// 整批记录只需一次写入与一次落盘
+					if (bOpened && this->WriteBytes_(strBytes, dtChunk, idxChunk - idxBegin, bError) != 0) {
+						this->SyncFile_();
+					}
+				}
+			} catch (const std::exception&) {
+			}
+
+			m_nProcessed_.fetch_add(vRecords.size(), std::memory_order_release);
+			m_nProcessed_.notify_all();
+			vRecords.clear();
+			continue;
+		}
 
-	ofs.write(strLine.c_str(), strLine.size());
-	ofs.close();
+		if (m_bStopping_.load(std::memory_order_acquire)) {
+			break;
+		}
+
+		m_bWriterIdle_.store(true, std::memory_order_seq_cst);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!m_pQueue_->Empty() || m_bStopping_.load(std::memory_order_acquire)) {
+			m_bWriterIdle_.store(false, std::memory_order_relaxed);
+			continue;
+		}
+		m_bWriterIdle_.wait(true, std::memory_order_acquire);
+	}
+}
+
+void Logger::WaitWritten_() const {
+	if (!m_pQueue_) {
+		return;
+	}
+
+	const size_t nTarget = m_pQueue_->GetPushedCount();
+	this->WakeWriter_();
+
+	size_t nProcessed;
+	while ((nProcessed = m_nProcessed_.load(std::memory_order_acquire)) < nTarget) {
+		m_nProcessed_.wait(nProcessed, std::memory_order_acquire);
+	}
+}
+
+void Logger::EnableAsync(size_t p_nCapacity, LogOverflowPolicy p_policy) {
+	if (m_pQueue_) {
+		return;
+	}
+
+	m_overflowPolicy_ = p_policy;
+	m_pQueue_         = std::make_unique<LockFreeQueue<LogRecord>>(p_nCapacity);
+	m_thWriter_       = std::thread(&Logger::WriterLoop_, this);
+}
+
+void Logger::Flush() const {
+	LogManager::GetInstance().FlushSuppressed_(this);
+
+	this->WaitWritten_();
+
+	if (m_bHasSinks_.load(std::memory_order_acquire)) {
+		std::shared_lock<std::shared_mutex> lock(m_mtxSinks_);
+		for (const auto& pSink : m_vSinks_) {
+			pSink->Flush();
+		}
+	}
+}
+
+void Logger::EnableFlightRecorder(size_t p_nCapacity) {
+	if (m_pRecorder_) {
+		return;
+	}
+
+	auto strDumpPath = std::filesystem::path(m_strLogFilePath_);
+	strDumpPath /= m_strName_ + TEXT(".flight.log");
+	m_pRecorder_ = std::make_unique<LogFlightRecorder>(p_nCapacity, strDumpPath.native());
+}
+
+bool Logger::DumpFlightRecorder() const noexcept {
+	return m_pRecorder_ && m_pRecorder_->Dump();
 }
 
 const String Logger::GetFullFilePath() const {
+	SharedLogFile& file = this->GetSharedFile_();
+
 	const DateTime dtNow = DateTimeUtils::Now();
-	auto strFileName     = std::filesystem::path(m_strLogFilePath_);
-	strFileName /= FORMAT("{}-{:%Y%m%d}.log", m_strName_, dtNow);
 
-	return strFileName.native();
+	std::lock_guard<std::mutex> guard(file.mtxWrite);
+	if (!file.strFullFilePath.empty() && dtNow < file.dtNextMidnight) {
+		return file.strFullFilePath;
+	}
+
+	return this->BuildFilePath_(dtNow, this->FindLastSegment_(dtNow));
 }
 
 _UTILS_END
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "StringUtils.h"
 
+#include <cstring>
+
 _UTILS_BEGIN
 
 std::wstring StringUtils::MultiByteToWideChar(const std::string& pc_str, int p_nCodePage) {
@@ -19,4 +21,61 @@ std::string StringUtils::WideCharToMultiByte(const std::wstring& p_wstr, int p_n
 	return result.data();
 }
 
+void StringUtils::AppendUtf8(std::string& p_strOut, std::wstring_view p_wsvText) {
+	static_assert(sizeof(wchar_t) == 2, "wchar_t is expected to be a UTF-16 code unit");
+
+	// 每个UTF-16代码单元最多对应3个字节，代理对的2个单元对应4个字节
+	const size_t nOldSize = p_strOut.size();
+	p_strOut.resize(nOldSize + p_wsvText.size() * 3);
+
+	char* pOut          = p_strOut.data() + nOldSize;
+	const wchar_t* pIn  = p_wsvText.data();
+	const wchar_t* pEnd = pIn + p_wsvText.size();
+	while (pIn < pEnd) {
+		if (pEnd - pIn >= 4) {
+			uint64_t nChunk;
+			std::memcpy(&nChunk, pIn, sizeof(nChunk));
+			if ((nChunk & 0xFF80'FF80'FF80'FF80ull) == 0) {
+				pOut[0] = static_cast<char>(pIn[0]);
+				pOut[1] = static_cast<char>(pIn[1]);
+				pOut[2] = static_cast<char>(pIn[2]);
+				pOut[3] = static_cast<char>(pIn[3]);
+				pIn += 4;
+				pOut += 4;
+				continue;
+			}
+		}
+
+		uint32_t nCode = *pIn++;
+		if (nCode < 0x80) {
+			*pOut++ = static_cast<char>(nCode);
+			continue;
+		}
+
+		if (nCode < 0x800) {
+			*pOut++ = static_cast<char>(0xC0 | (nCode >> 6));
+			*pOut++ = static_cast<char>(0x80 | (nCode & 0x3F));
+			continue;
+		}
+
+		if (0xD800 <= nCode && nCode < 0xDC00 && pIn < pEnd && 0xDC00 <= *pIn && *pIn < 0xE000) {
+			nCode   = 0x10000 + ((nCode - 0xD800) << 10) + (*pIn++ - 0xDC00);
+			*pOut++ = static_cast<char>(0xF0 | (nCode >> 18));
+			*pOut++ = static_cast<char>(0x80 | ((nCode >> 12) & 0x3F));
+			*pOut++ = static_cast<char>(0x80 | ((nCode >> 6) & 0x3F));
+			*pOut++ = static_cast<char>(0x80 | (nCode & 0x3F));
+			continue;
+		}
+
+		if (0xD800 <= nCode && nCode < 0xE000) {
+			nCode = 0xFFFD;
+		}
+		*pOut++ = static_cast<char>(0xE0 | (nCode >> 12));
+		*pOut++ = static_cast<char>(0x80 | ((nCode >> 6) & 0x3F));
+		*pOut++ = static_cast<char>(0x80 | (nCode & 0x3F));
+	}
+
+	p_strOut.resize(static_cast<size_t>(pOut - p_strOut.data()));
+}
+
 _UTILS_END
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include <tchar.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Logger.h"
+#include "TestCheck.h"
+
+using namespace Utils;
+
+namespace {
+	/// <summary>
+	/// 溢出测试使用的队列容量，已是2的幂
+	/// </summary>
+	constexpr size_t QUEUE_CAPACITY = 4;
+
+	/// <summary>
+	/// 队列已满后继续提交的记录数
+	/// </summary>
+	constexpr size_t OVERFLOW_COUNT = 4;
+
+	/// <summary>
+	/// 记下收到的每条记录的消息
+	/// </summary>
+	class CaptureSink : public LogSink {
+	private:
+		mutable std::mutex m_mtxMsgs_;
+		std::vector<String> m_vMsgs_;
+
+	public:
+		void Write(const LogSinkRecord& pc_record) override {
+			std::lock_guard<std::mutex> guard(m_mtxMsgs_);
+			m_vMsgs_.emplace_back(pc_record.svMsg);
+		}
+
+		size_t GetCount() const {
+			std::lock_guard<std::mutex> guard(m_mtxMsgs_);
+			return m_vMsgs_.size();
+		}
+
+		bool Contains(const String& pc_strMsg) const {
+			std::lock_guard<std::mutex> guard(m_mtxMsgs_);
+			return std::find(m_vMsgs_.begin(), m_vMsgs_.end(), pc_strMsg) != m_vMsgs_.end();
+		}
+
+		std::vector<String> TakeMessages() {
+			std::lock_guard<std::mutex> guard(m_mtxMsgs_);
+			return std::exchange(m_vMsgs_, {});
+		}
+	};
+
+	/// <summary>
+	/// Hold 之后收到的记录会阻塞写线程，直到 Release，用于让队列确定地填满
+	/// </summary>
+	class GateSink : public CaptureSink {
+	private:
+		std::mutex m_mtxGate_;
+		std::condition_variable m_cvGate_;
+		bool m_bHeld_    = false;
+		bool m_bBlocked_ = false;
+
+	public:
+		void Write(const LogSinkRecord& pc_record) override {
+			CaptureSink::Write(pc_record);
+
+			std::unique_lock<std::mutex> lock(m_mtxGate_);
+			m_bBlocked_ = m_bHeld_;
+			m_cvGate_.notify_all();
+			m_cvGate_.wait(lock, [this]() { return !m_bHeld_; });
+			m_bBlocked_ = false;
+		}
+
+		void Hold() {
+			std::lock_guard<std::mutex> guard(m_mtxGate_);
+			m_bHeld_ = true;
+		}
+
+		void WaitUntilBlocked() {
+			std::unique_lock<std::mutex> lock(m_mtxGate_);
+			m_cvGate_.wait(lock, [this]() { return m_bBlocked_; });
+		}
+
+		void Release() {
+			{
+				std::lock_guard<std::mutex> guard(m_mtxGate_);
+				m_bHeld_ = false;
+			}
+			m_cvGate_.notify_all();
+		}
+	};
+
+	std::vector<String> Numbers(size_t p_nFirst, size_t p_nLast) {
+		std::vector<String> vMsgs;
+		for (size_t idx = p_nFirst; idx <= p_nLast; ++idx) {
+			vMsgs.push_back(FORMAT("{}", idx));
+		}
+		return vMsgs;
+	}
+
+	std::string ReadAll(const std::filesystem::path& pc_path) {
+		std::ifstream stream(pc_path, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	/// <summary>
+	/// 检查每个线程的记录按提交顺序出现且没有遗漏，消息格式为"线程序号 记录序号"
+	/// </summary>
+	bool IsOrderedPerThread(const std::vector<std::pair<size_t, size_t>>& pc_vRecords, size_t p_nThreads, size_t p_nRecords) {
+		std::vector<size_t> vnNext(p_nThreads, 0);
+		for (const auto& [nThread, nRecord] : pc_vRecords) {
+			if (nThread >= p_nThreads || nRecord != vnNext[nThread]) {
+				return false;
+			}
+			++vnNext[nThread];
+		}
+		return std::all_of(vnNext.begin(), vnNext.end(), [p_nRecords](size_t p_nCount) { return p_nCount == p_nRecords; });
+	}
+
+	/// <summary>
+	/// 写线程阻塞在记录 0 上时提交 QUEUE_CAPACITY 条记录填满队列，再提交 OVERFLOW_COUNT 条
+	/// </summary>
+	std::vector<String> RunOverflow(const std::filesystem::path& pc_dir, const TCHAR* p_cszName, LogOverflowPolicy p_policy, size_t& p_nDropped) {
+		Logger logger(p_cszName, pc_dir.native(), LogLevel::TRACE);
+		auto pSink = std::make_shared<GateSink>();
+		logger.AddSink(pSink);
+		logger.EnableAsync(QUEUE_CAPACITY, p_policy);
+
+		pSink->Hold();
+		logger.Info(TEXT(__FUNCTION__), TEXT("{}"), 0);
+		pSink->WaitUntilBlocked();
+
+		for (size_t idx = 1; idx <= QUEUE_CAPACITY + OVERFLOW_COUNT; ++idx) {
+			logger.Info(TEXT(__FUNCTION__), TEXT("{}"), idx);
+		}
+
+		pSink->Release();
+		logger.Flush();
+		p_nDropped = logger.GetDroppedCount();
+		return pSink->TakeMessages();
+	}
+
+	void TestDropNewest(const std::filesystem::path& pc_dir) {
+		size_t nDropped                 = 0;
+		const std::vector<String> vMsgs = RunOverflow(pc_dir, TEXT("DropNewest"), LogOverflowPolicy::DROP_NEWEST, nDropped);
+		CHECK(vMsgs == Numbers(0, QUEUE_CAPACITY));
+		CHECK(nDropped == OVERFLOW_COUNT);
+	}
+
+	void TestDropOldest(const std::filesystem::path& pc_dir) {
+		size_t nDropped                 = 0;
+		const std::vector<String> vMsgs = RunOverflow(pc_dir, TEXT("DropOldest"), LogOverflowPolicy::DROP_OLDEST, nDropped);
+
+		std::vector<String> vExpected = Numbers(0, 0);
+		for (const String& strMsg : Numbers(OVERFLOW_COUNT + 1, QUEUE_CAPACITY + OVERFLOW_COUNT)) {
+			vExpected.push_back(strMsg);
+		}
+		CHECK(vMsgs == vExpected);
+		CHECK(nDropped == OVERFLOW_COUNT);
+	}
+
+	void TestBlock(const std::filesystem::path& pc_dir) {
+		Logger logger(TEXT("Block"), pc_dir.native(), LogLevel::TRACE);
+		auto pSink = std::make_shared<GateSink>();
+		logger.AddSink(pSink);
+		logger.EnableAsync(QUEUE_CAPACITY, LogOverflowPolicy::BLOCK);
+
+		pSink->Hold();
+		logger.Info(TEXT(__FUNCTION__), TEXT("{}"), 0);
+		pSink->WaitUntilBlocked();
+
+		for (size_t idx = 1; idx <= QUEUE_CAPACITY; ++idx) {
+			logger.Info(TEXT(__FUNCTION__), TEXT("{}"), idx);
+		}
+
+		// 队列已满，下一条记录应等到写线程放行后才返回
+		std::atomic<bool> bReturned { false };
+		std::thread thBlocked([&logger, &bReturned]() {
+			logger.Info(TEXT(__FUNCTION__), TEXT("{}"), QUEUE_CAPACITY + 1);
+			bReturned.store(true);
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		CHECK(!bReturned.load());
+
+		pSink->Release();
+		thBlocked.join();
+		logger.Flush();
+		CHECK(pSink->TakeMessages() == Numbers(0, QUEUE_CAPACITY + 1));
+		CHECK(logger.GetDroppedCount() == 0);
+	}
+
+	/// <summary>
+	/// Flush 返回时，调用前提交的记录都已写入文件并交给输出目标；同一线程的记录保持提交顺序
+	/// </summary>
+	void TestFlushOrdering(const std::filesystem::path& pc_dir) {
+		constexpr size_t THREAD_COUNT = 4;
+		constexpr size_t RECORD_COUNT = 1000;
+
+		Logger logger(TEXT("FlushOrdering"), pc_dir.native(), LogLevel::TRACE);
+		auto pSink = std::make_shared<CaptureSink>();
+		logger.AddSink(pSink);
+		logger.EnableAsync(64, LogOverflowPolicy::BLOCK);
+
+		// 各线程 Flush 后立即检查，结果在主线程中汇总
+		std::vector<char> vbFlushed(THREAD_COUNT, false);
+		std::vector<std::thread> vThreads;
+		for (size_t nThread = 0; nThread < THREAD_COUNT; ++nThread) {
+			vThreads.emplace_back([&logger, &pSink, &vbFlushed, nThread]() {
+				for (size_t nRecord = 0; nRecord < RECORD_COUNT; ++nRecord) {
+					logger.Info(TEXT(__FUNCTION__), TEXT("{} {}"), nThread, nRecord);
+				}
+				logger.Flush();
+				vbFlushed[nThread] = pSink->Contains(FORMAT("{} {}", nThread, RECORD_COUNT - 1));
+			});
+		}
+		for (std::thread& thread : vThreads) {
+			thread.join();
+		}
+		for (const char bFlushed : vbFlushed) {
+			CHECK(bFlushed);
+		}
+
+		logger.Info(TEXT(__FUNCTION__), TEXT("last"));
+		logger.Flush();
+
+		std::vector<String> vMsgs = pSink->TakeMessages();
+		CHECK(vMsgs.size() == THREAD_COUNT * RECORD_COUNT + 1);
+		CHECK(!vMsgs.empty() && vMsgs.back() == TEXT("last"));
+
+		std::vector<std::pair<size_t, size_t>> vRecords;
+		for (size_t idx = 0; idx + 1 < vMsgs.size(); ++idx) {
+			std::basic_istringstream<TCHAR> stream(vMsgs[idx]);
+			std::pair<size_t, size_t> record;
+			stream >> record.first >> record.second;
+			vRecords.push_back(record);
+		}
+		CHECK(IsOrderedPerThread(vRecords, THREAD_COUNT, RECORD_COUNT));
+
+		const std::string strFile = ReadAll(std::filesystem::path(logger.GetFullFilePath()));
+		CHECK(static_cast<size_t>(std::count(strFile.begin(), strFile.end(), '\n')) == THREAD_COUNT * RECORD_COUNT + 1);
+	}
+
+	/// <summary>
+	/// 落盘策略不为 NONE 时，异步模式下的错误记录在返回前已由写线程写入
+	/// </summary>
+	void TestAsyncErrorWaitsForWriter(const std::filesystem::path& pc_dir) {
+		constexpr size_t RECORD_COUNT = 100;
+
+		Logger logger(TEXT("AsyncError"), pc_dir.native(), LogLevel::TRACE);
+		logger.SetDurability(LogDurability::SYNC_ON_ERROR);
+		auto pSink = std::make_shared<CaptureSink>();
+		logger.AddSink(pSink);
+		logger.EnableAsync(64, LogOverflowPolicy::BLOCK);
+
+		for (size_t idx = 0; idx < RECORD_COUNT; ++idx) {
+			logger.Info(TEXT(__FUNCTION__), TEXT("{}"), idx);
+		}
+		logger.Error(TEXT(__FUNCTION__), TEXT("{}"), RECORD_COUNT);
+		CHECK(pSink->GetCount() == RECORD_COUNT + 1);
+	}
+
+	/// <summary>
+	/// 多个线程同时写入需要落盘的记录，由其中一个线程代为落盘，所有记录都应完整、按各线程的顺序写入文件
+	/// </summary>
+	void TestGroupCommit(const std::filesystem::path& pc_dir) {
+		constexpr size_t THREAD_COUNT = 8;
+		constexpr size_t RECORD_COUNT = 200;
+
+		Logger logger(TEXT("GroupCommit"), pc_dir.native(), LogLevel::TRACE);
+		logger.SetDurability(LogDurability::SYNC_ON_ERROR);
+
+		std::vector<std::thread> vThreads;
+		for (size_t nThread = 0; nThread < THREAD_COUNT; ++nThread) {
+			vThreads.emplace_back([&logger, nThread]() {
+				for (size_t nRecord = 0; nRecord < RECORD_COUNT; ++nRecord) {
+					logger.Error(TEXT(__FUNCTION__), TEXT("{} {}"), nThread, nRecord);
+				}
+			});
+		}
+		for (std::thread& thread : vThreads) {
+			thread.join();
+		}
+
+		// 每行形如"[时间] [级别]  函数: 线程序号 记录序号"
+		std::vector<std::pair<size_t, size_t>> vRecords;
+		std::istringstream stream(ReadAll(std::filesystem::path(logger.GetFullFilePath())));
+		for (std::string strLine; std::getline(stream, strLine);) {
+			const size_t nPos = strLine.rfind(": ");
+			std::pair<size_t, size_t> record { THREAD_COUNT, 0 };
+			if (nPos != std::string::npos) {
+				std::istringstream(strLine.substr(nPos + 2)) >> record.first >> record.second;
+			}
+			vRecords.push_back(record);
+		}
+		CHECK(IsOrderedPerThread(vRecords, THREAD_COUNT, RECORD_COUNT));
+	}
+}
+
+int _tmain() {
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / TEXT("UtilsAsyncLoggerTest");
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+
+	TestDropNewest(dir);
+	TestDropOldest(dir);
+	TestBlock(dir);
+	TestFlushOrdering(dir);
+	TestAsyncErrorWaitsForWriter(dir);
+	TestGroupCommit(dir);
+
+	std::error_code ec;
+	std::filesystem::remove_all(dir, ec);
+	return ReportChecks();
+}
\ No newline at end of file
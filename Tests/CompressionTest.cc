@@ -0,0 +1,180 @@
+#include <tchar.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Compression.h"
+#include "TestCheck.h"
+
+using namespace Utils;
+
+namespace {
+	std::vector<byte> MakeBytes(const std::string& pc_strText) {
+		return std::vector<byte>(pc_strText.begin(), pc_strText.end());
+	}
+
+	/// <summary>
+	/// 固定种子的伪随机数据，几乎不含可匹配的序列
+	/// </summary>
+	std::vector<byte> MakeNoise(size_t p_nSize) {
+		std::mt19937 rng(20240601);
+		std::vector<byte> vbData(p_nSize);
+		for (byte& bValue : vbData) {
+			bValue = static_cast<byte>(rng());
+		}
+		return vbData;
+	}
+
+	bool RoundTrips(const std::vector<byte>& pc_vbData) {
+		const std::vector<byte> vbPacked = CompressionUtils::Compress(pc_vbData.data(), pc_vbData.size());
+		return CompressionUtils::Decompress(vbPacked.data(), vbPacked.size(), pc_vbData.size()) == pc_vbData;
+	}
+
+	bool RejectsCorrupt(const std::vector<byte>& pc_vbPacked, size_t p_nRawSize) {
+		try {
+			CompressionUtils::Decompress(pc_vbPacked.data(), pc_vbPacked.size(), p_nRawSize);
+		} catch (const InvalidArgumentException&) {
+			return true;
+		}
+		return false;
+	}
+
+	void TestEmpty() {
+		const std::vector<byte> vbPacked = CompressionUtils::Compress(nullptr, 0);
+		CHECK(vbPacked == std::vector<byte> { 0 });
+		CHECK(CompressionUtils::Decompress(vbPacked.data(), vbPacked.size(), 0).empty());
+		CHECK(CompressionUtils::Decompress(nullptr, 0, 0).empty());
+	}
+
+	/// <summary>
+	/// 不超过 MATCH_LIMIT（12字节）的输入不查找匹配，整体作为字面量输出
+	/// </summary>
+	void TestShorterThanMatchLimit() {
+		for (size_t nSize = 1; nSize <= 12; ++nSize) {
+			const std::vector<byte> vbData(nSize, 'a');
+			const std::vector<byte> vbPacked = CompressionUtils::Compress(vbData.data(), vbData.size());
+			CHECK(vbPacked.size() == nSize + 1);
+			CHECK(RoundTrips(vbData));
+		}
+	}
+
+	/// <summary>
+	/// 偏移小于匹配长度时匹配区与输出重叠，解压需逐字节复制
+	/// </summary>
+	void TestOverlappingMatches() {
+		const std::vector<byte> vbRun(1000, 'x');
+		const std::vector<byte> vbPacked = CompressionUtils::Compress(vbRun.data(), vbRun.size());
+		CHECK(vbPacked.size() < 32);
+		CHECK(RoundTrips(vbRun));
+
+		std::string strPattern;
+		for (int idx = 0; idx < 200; ++idx) {
+			strPattern += "abc";
+		}
+		CHECK(RoundTrips(MakeBytes(strPattern)));
+
+		// 手工构造：字面量 "ab"，随后偏移 2、长度 6 的匹配，再以 5 个字面量结尾
+		const std::vector<byte> vbManual { 0x22, 'a', 'b', 0x02, 0x00, 0x50, 'a', 'b', 'a', 'b', 'c' };
+		CHECK(CompressionUtils::Decompress(vbManual.data(), vbManual.size(), 13) == MakeBytes("ababababababc"));
+	}
+
+	void TestIncompressible() {
+		const std::vector<byte> vbNoise = MakeNoise(64 * 1024);
+		const std::vector<byte> vbPacked = CompressionUtils::Compress(vbNoise.data(), vbNoise.size());
+		CHECK(vbPacked.size() >= vbNoise.size());
+		CHECK(vbPacked.size() <= vbNoise.size() + vbNoise.size() / 255 + 16);
+		CHECK(RoundTrips(vbNoise));
+
+		// 字面量与匹配交替，且长度都超过15，需使用扩展长度字节
+		std::vector<byte> vbMixed = MakeNoise(300);
+		vbMixed.insert(vbMixed.end(), 700, 'm');
+		const std::vector<byte> vbTail = MakeNoise(40);
+		vbMixed.insert(vbMixed.end(), vbTail.begin(), vbTail.end());
+		CHECK(RoundTrips(vbMixed));
+	}
+
+	void TestCorrupt() {
+		const std::vector<byte> vbData   = MakeBytes("log line log line log line log line log line\n");
+		const std::vector<byte> vbPacked = CompressionUtils::Compress(vbData.data(), vbData.size());
+		CHECK(vbPacked.size() < vbData.size());
+
+		// 截断在各个位置
+		for (size_t nSize = 1; nSize < vbPacked.size(); ++nSize) {
+			CHECK(RejectsCorrupt(std::vector<byte>(vbPacked.begin(), vbPacked.begin() + nSize), vbData.size()));
+		}
+
+		// 原始长度与数据不符
+		CHECK(RejectsCorrupt(vbPacked, vbData.size() - 1));
+		CHECK(RejectsCorrupt(vbPacked, vbData.size() + 1));
+
+		// 偏移为0或超出已输出的数据
+		CHECK(RejectsCorrupt({ 0x10, 'a', 0x00, 0x00 }, 5));
+		CHECK(RejectsCorrupt({ 0x10, 'a', 0x02, 0x00 }, 5));
+
+		// 扩展长度字节缺失
+		CHECK(RejectsCorrupt({ 0xF0 }, 15));
+		CHECK(RejectsCorrupt({ 0xF0, 0xFF }, 270));
+	}
+
+	std::string ReadAll(const std::filesystem::path& pc_path) {
+		std::ifstream stream(pc_path, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	void WriteAll(const std::filesystem::path& pc_path, const std::string& pc_strData) {
+		std::ofstream stream(pc_path, std::ios::binary | std::ios::trunc);
+		stream.write(pc_strData.data(), static_cast<std::streamsize>(pc_strData.size()));
+	}
+
+	/// <summary>
+	/// 超过一个文件块（4MiB），且同时包含可压缩块与原样存储的块
+	/// </summary>
+	void TestCompressFile(const std::filesystem::path& pc_dir) {
+		const std::filesystem::path pathRaw      = pc_dir / TEXT("raw.log");
+		const std::filesystem::path pathPacked   = pc_dir / TEXT("raw.log.ulz");
+		const std::filesystem::path pathRestored = pc_dir / TEXT("restored.log");
+
+		std::string strData;
+		while (strData.size() < 4 * 1024 * 1024) {
+			strData += "[2024-06-01 12:00:00.000] [INFO ]  main: request handled\n";
+		}
+		const std::vector<byte> vbNoise = MakeNoise(100 * 1024);
+		strData.append(vbNoise.begin(), vbNoise.end());
+		WriteAll(pathRaw, strData);
+
+		CHECK(CompressionUtils::CompressFile(pathRaw.native(), pathPacked.native()));
+		CHECK(std::filesystem::file_size(pathPacked) < strData.size() / 4);
+		CHECK(CompressionUtils::DecompressFile(pathPacked.native(), pathRestored.native()));
+		CHECK(ReadAll(pathRestored) == strData);
+
+		WriteAll(pathPacked, "not a packed file");
+		bool bThrown = false;
+		try {
+			CompressionUtils::DecompressFile(pathPacked.native(), pathRestored.native());
+		} catch (const InvalidArgumentException&) {
+			bThrown = true;
+		}
+		CHECK(bThrown);
+	}
+}
+
+int _tmain() {
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / TEXT("UtilsCompressionTest");
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+
+	TestEmpty();
+	TestShorterThanMatchLimit();
+	TestOverlappingMatches();
+	TestIncompressible();
+	TestCorrupt();
+	TestCompressFile(dir);
+
+	std::error_code ec;
+	std::filesystem::remove_all(dir, ec);
+	return ReportChecks();
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <tchar.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "Logger.h"
+#include "TestCheck.h"
+
+using namespace Utils;
+
+namespace {
+	template <typename _Type>
+	void AppendRaw(std::string& p_strOut, const _Type& pc_value) {
+		p_strOut.append(reinterpret_cast<const char*>(&pc_value), sizeof(_Type));
+	}
+
+	std::string BuildHeader() {
+		std::string strHeader(LogBinaryFormat::MAGIC, sizeof(LogBinaryFormat::MAGIC));
+		AppendRaw(strHeader, static_cast<uint32_t>(sizeof(TCHAR)));
+		AppendRaw(strHeader, static_cast<int64_t>(10'000'000));
+		return strHeader;
+	}
+
+	/// <summary>
+	/// 一条参数为 0 的调用点记录，记录本身以'\0'结尾
+	/// </summary>
+	std::string BuildRecord(uint32_t p_nSiteId) {
+		std::string strArgs(1, static_cast<char>(LogBinaryFormat::Arg::INT));
+		AppendRaw(strArgs, static_cast<int64_t>(0));
+
+		std::string strRecord(1, static_cast<char>(LogBinaryFormat::Entry::RECORD));
+		AppendRaw(strRecord, p_nSiteId);
+		AppendRaw(strRecord, static_cast<int64_t>(1));
+		AppendRaw(strRecord, static_cast<uint8_t>(3));
+		AppendRaw(strRecord, static_cast<uint32_t>(strArgs.size()));
+		return strRecord + strArgs;
+	}
+
+	std::string ReadAll(const std::filesystem::path& pc_path) {
+		std::ifstream stream(pc_path, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	void WriteAll(const std::filesystem::path& pc_path, const std::string& pc_strData) {
+		std::ofstream stream(pc_path, std::ios::binary | std::ios::trunc);
+		stream.write(pc_strData.data(), static_cast<std::streamsize>(pc_strData.size()));
+	}
+
+	/// <summary>
+	/// 模拟内存映射写入后进程崩溃：文件长度为整块，有效内容之后全为预分配的'\0'
+	/// </summary>
+	void TestBinaryReopenAfterUncleanClose(const std::filesystem::path& pc_dir) {
+		constexpr size_t CHUNK_SIZE = 4096;
+
+		const std::filesystem::path path = pc_dir / TEXT("crashed.blog");
+		const std::string strValid       = BuildHeader() + BuildRecord(1) + BuildRecord(2);
+		WriteAll(path, strValid + std::string(CHUNK_SIZE - strValid.size(), '\0'));
+		CHECK(LogBinaryFormat::FindValidLength(strValid.data(), strValid.size()) == strValid.size());
+
+		MappedLogFileWriter writer(CHUNK_SIZE, &LogBinaryFormat::FindValidLength);
+		CHECK(writer.Open(path.native(), true));
+		CHECK(writer.GetSize() == strValid.size());
+
+		const std::string strAppended = BuildRecord(3);
+		CHECK(writer.Write(strAppended.data(), strAppended.size()));
+		writer.Close();
+
+		const std::string strContent = ReadAll(path);
+		CHECK(strContent == strValid + strAppended);
+		CHECK(LogBinaryFormat::FindValidLength(strContent.data(), strContent.size()) == strContent.size());
+	}
+
+	/// <summary>
+	/// 崩溃时最后一条记录只写入了一部分，重新打开后应从上一条完整记录之后继续写入
+	/// </summary>
+	void TestBinaryReopenAfterTornRecord(const std::filesystem::path& pc_dir) {
+		constexpr size_t CHUNK_SIZE = 4096;
+
+		const std::filesystem::path path = pc_dir / TEXT("torn.blog");
+		const std::string strValid       = BuildHeader() + BuildRecord(1);
+		const std::string strTorn        = BuildRecord(2).substr(0, 6);
+		WriteAll(path, strValid + strTorn + std::string(CHUNK_SIZE - strValid.size() - strTorn.size(), '\0'));
+
+		MappedLogFileWriter writer(CHUNK_SIZE, &LogBinaryFormat::FindValidLength);
+		CHECK(writer.Open(path.native(), true));
+		CHECK(writer.GetSize() == strValid.size());
+		writer.Close();
+		CHECK(ReadAll(path) == strValid);
+	}
+
+	void TestTextReopenAfterUncleanClose(const std::filesystem::path& pc_dir) {
+		constexpr size_t CHUNK_SIZE = 4096;
+
+		const std::filesystem::path path = pc_dir / TEXT("crashed.log");
+		const std::string strValid       = "first\r\n";
+		WriteAll(path, strValid + std::string(CHUNK_SIZE - strValid.size(), '\0'));
+
+		MappedLogFileWriter writer(CHUNK_SIZE);
+		CHECK(writer.Open(path.native(), false));
+		CHECK(writer.GetSize() == strValid.size());
+		CHECK(writer.Write("second\n", 7));
+		writer.Close();
+		CHECK(ReadAll(path) == strValid + "second\r\n");
+	}
+}
+
+int _tmain() {
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / TEXT("UtilsLogFileWriterTest");
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+
+	TestBinaryReopenAfterUncleanClose(dir);
+	TestBinaryReopenAfterTornRecord(dir);
+	TestTextReopenAfterUncleanClose(dir);
+
+	std::filesystem::remove_all(dir);
+	return ReportChecks();
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <tchar.h>
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Logger.h"
+#include "TestCheck.h"
+
+using namespace Utils;
+
+namespace {
+	/// <summary>
+	/// 记下收到的每条记录的级别
+	/// </summary>
+	class CaptureSink : public LogSink {
+	private:
+		std::mutex m_mtxLevels_;
+		std::vector<LogLevel> m_vLevels_;
+
+	public:
+		void Write(const LogSinkRecord& pc_record) override {
+			std::lock_guard<std::mutex> guard(m_mtxLevels_);
+			m_vLevels_.push_back(pc_record.level);
+		}
+
+		std::vector<LogLevel> TakeLevels() {
+			std::lock_guard<std::mutex> guard(m_mtxLevels_);
+			return std::exchange(m_vLevels_, {});
+		}
+	};
+
+	void LogAllLevels(const Logger& pc_logger) {
+		pc_logger.Trace(TEXT(__FUNCTION__), TEXT("trace"));
+		pc_logger.Debug(TEXT(__FUNCTION__), TEXT("debug"));
+		pc_logger.Info(TEXT(__FUNCTION__), TEXT("info"));
+		pc_logger.Warn(TEXT(__FUNCTION__), TEXT("warn"));
+		pc_logger.Error(TEXT(__FUNCTION__), TEXT("error"));
+		pc_logger.Info(TEXT(__FUNCTION__), TEXT("info {}"), 1);
+		pc_logger.LogFields(LogLevel::INFO, TEXT(__FUNCTION__), TEXT("fields"), { { TEXT("key"), 1 } });
+	}
+
+	void TestLoadConfig(const std::filesystem::path& pc_dir) {
+		const std::filesystem::path pathConfig = pc_dir / TEXT("levels.conf");
+		{
+			std::ofstream ofs(pathConfig, std::ios::trunc);
+			ofs << "# runtime levels\n"
+			    << "WarnLogger = warn\n"
+			    << "SilentLogger = NONE\n";
+		}
+
+		// 读取配置前已存在的 Logger 与之后创建的 Logger 都应使用配置中的级别
+		Logger warnLogger(TEXT("WarnLogger"), pc_dir.native(), LogLevel::TRACE);
+		auto pWarnSink = std::make_shared<CaptureSink>();
+		warnLogger.AddSink(pWarnSink);
+
+		CHECK(LogManager::GetInstance().LoadConfig(pathConfig.native()));
+		CHECK(warnLogger.GetLogLevel() == LogLevel::WARN);
+
+		Logger silentLogger(TEXT("SilentLogger"), pc_dir.native(), LogLevel::TRACE);
+		auto pSilentSink = std::make_shared<CaptureSink>();
+		silentLogger.AddSink(pSilentSink);
+		CHECK(silentLogger.GetLogLevel() == LogLevel::NONE);
+
+		LogAllLevels(warnLogger);
+		CHECK((pWarnSink->TakeLevels() == std::vector<LogLevel> { LogLevel::WARN, LogLevel::ERR }));
+
+		LogAllLevels(silentLogger);
+		CHECK(pSilentSink->TakeLevels().empty());
+	}
+}
+
+int _tmain() {
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / TEXT("UtilsLoggerLevelTest");
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+
+	TestLoadConfig(dir);
+
+	std::error_code ec;
+	std::filesystem::remove_all(dir, ec);
+	return ReportChecks();
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include <tchar.h>
+
+#include <utility>
+#include <vector>
+
+#include "StringUtils.h"
+#include "TestCheck.h"
+
+using namespace Utils;
+
+namespace {
+	template <typename _RangeT>
+	std::vector<String> Collect(const _RangeT& pc_range) {
+		std::vector<String> vParts;
+		for (StringView svPart : pc_range) {
+			vParts.emplace_back(svPart);
+		}
+		return vParts;
+	}
+
+	/// <summary>
+	/// 能否以给定类型的分隔符调用 SplitView
+	/// </summary>
+	template <typename _SepT>
+	concept CanSplitBy = requires(const String& pc_strValue, _SepT&& p_sep) { StringUtils::SplitView(pc_strValue, std::forward<_SepT>(p_sep)); };
+
+	// 分隔符只被引用，临时字符串在范围 for 的初始化表达式结束时即被销毁，因此不被接受
+	static_assert(!CanSplitBy<String>);
+	static_assert(CanSplitBy<const String&>);
+	static_assert(CanSplitBy<StringView>);
+	static_assert(CanSplitBy<const TCHAR(&)[3]>);
+
+	void TestIteratorOutlivesRange() {
+		const String strValue = TEXT("a::b::c");
+		const String strSep   = TEXT("::");
+
+		auto iter = StringUtils::SplitView(strValue, strSep).begin();
+		CHECK(*iter == TEXT("a"));
+		++iter;
+		CHECK(*iter == TEXT("b"));
+		++iter;
+		CHECK(*iter == TEXT("c"));
+		++iter;
+		CHECK(iter == std::default_sentinel);
+	}
+
+	void TestLongSeparator() {
+		const String strSep(40, TEXT('-'));
+		const String strValue = TEXT("left") + strSep + TEXT("right");
+		CHECK((Collect(StringUtils::SplitView(strValue, strSep)) == std::vector<String> { TEXT("left"), TEXT("right") }));
+	}
+
+	template <typename _SetT>
+	concept CanSplitAnyOf = requires(StringView p_svValue, _SetT&& p_set) { StringUtils::SplitAnyOf(p_svValue, std::forward<_SetT>(p_set)); };
+
+	// 字符集合同样只被引用
+	static_assert(!CanSplitAnyOf<CharSet>);
+	static_assert(!CanSplitAnyOf<const TCHAR(&)[3]>);
+	static_assert(CanSplitAnyOf<const CharSet&>);
+
+	void TestCharSet() {
+		static constexpr CharSet SEPARATORS(TEXT(",;"));
+
+		// 迭代器不依赖临时的范围对象，只依赖集合
+		auto iter = StringUtils::SplitAnyOf(StringView(TEXT("a,b;;c")), SEPARATORS, SplitOptions::SKIP_EMPTY).begin();
+		std::vector<String> vParts;
+		for (; iter != std::default_sentinel; ++iter) {
+			vParts.emplace_back(*iter);
+		}
+		CHECK((vParts == std::vector<String> { TEXT("a"), TEXT("b"), TEXT("c") }));
+
+		// 跨过整块向量比较的长输入，以及超过 MAX_VECTOR_CHARS 个字符、只能查位图的集合
+		const String strLong = String(40, TEXT('x')) + TEXT(" y\tz");
+		vParts.clear();
+		for (StringView svPart : StringUtils::SplitAnyOf(strLong, CharSet::Blanks())) {
+			vParts.emplace_back(svPart);
+		}
+		CHECK((vParts == std::vector<String> { String(40, TEXT('x')), TEXT("y"), TEXT("z") }));
+
+		static constexpr CharSet DIGITS(TEXT("0123456789"));
+		static_assert(DIGITS.GetVectorChars().empty());
+		const String strDigit = strLong + TEXT("7w");
+		CHECK(Collect(StringUtils::SplitAnyOf(strDigit, DIGITS)).size() == 2);
+	}
+}
+
+int _tmain() {
+	TestIteratorOutlivesRange();
+	TestLongSeparator();
+	TestCharSet();
+	return ReportChecks();
+}
\ No newline at end of file
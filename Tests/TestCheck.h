@@ -0,0 +1,31 @@
+#pragma once
+#include <iostream>
+
+/// <summary>
+/// 失败的检查数，由 ReportChecks 汇总为进程的退出码
+/// </summary>
+inline int g_nFailedChecks = 0;
+
+/// <summary>
+/// 检查表达式是否成立，失败时输出位置并继续执行后续检查
+/// </summary>
+#define CHECK(expr)                                                                                \
+	do {                                                                                           \
+		if (!(expr)) {                                                                             \
+			std::cerr << __FILE__ << "(" << __LINE__ << "): CHECK(" #expr ") failed" << std::endl; \
+			++g_nFailedChecks;                                                                     \
+		}                                                                                          \
+	} while (false)
+
+/// <summary>
+/// 输出检查结果
+/// </summary>
+/// <returns>进程的退出码，有检查失败时为 1</returns>
+inline int ReportChecks() {
+	if (g_nFailedChecks != 0) {
+		std::cerr << g_nFailedChecks << " check(s) failed" << std::endl;
+		return 1;
+	}
+	std::cout << "all checks passed" << std::endl;
+	return 0;
+}
\ No newline at end of file
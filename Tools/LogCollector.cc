@@ -0,0 +1,116 @@
+#include <fcntl.h>
+#include <io.h>
+#include <tchar.h>
+
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "LogSink.h"
+
+// Windows.h 已按 WIN32_LEAN_AND_MEAN 引入，Winsock 的头文件需在其后
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+
+using namespace Utils;
+
+namespace {
+	std::mutex g_mtxOutput;
+
+	bool RecvAll(SOCKET p_socket, char* p_pData, size_t p_nSize) {
+		while (p_nSize > 0) {
+			const int nReceived = ::recv(p_socket, p_pData, static_cast<int>(p_nSize), 0);
+			if (nReceived <= 0) {
+				return false;
+			}
+			p_pData += nReceived;
+			p_nSize -= static_cast<size_t>(nReceived);
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// 逐帧读取一个连接，整帧写出，保证不同连接的记录不会在行内交错；连接中断时未收全的帧被丢弃。
+	/// <para>负载长度超过 SocketLogSink::MAX_FRAME_SIZE 时说明数据流已损坏或失去同步，关闭连接而不按该长度分配内存</para>
+	/// </summary>
+	void Serve(SOCKET p_socket, FILE* p_pOutput) {
+		std::string strPayload;
+		uint32_t nPayload;
+		while (RecvAll(p_socket, reinterpret_cast<char*>(&nPayload), sizeof(nPayload))) {
+			if (nPayload > SocketLogSink::MAX_FRAME_SIZE) {
+				std::lock_guard<std::mutex> guard(g_mtxOutput);
+				std::cerr << "frame of " << nPayload << " bytes exceeds the limit, closing connection" << std::endl;
+				break;
+			}
+			strPayload.resize(nPayload);
+			if (!RecvAll(p_socket, strPayload.data(), strPayload.size())) {
+				break;
+			}
+
+			std::lock_guard<std::mutex> guard(g_mtxOutput);
+			std::fwrite(strPayload.data(), 1, strPayload.size(), p_pOutput);
+			std::fflush(p_pOutput);
+		}
+		::closesocket(p_socket);
+	}
+}
+
+/// <summary>
+/// SocketLogSink 的收集进程，可作为测试时的替身：监听本机端口，将收到的记录原样追加到文件或标准输出
+/// <para>用法：LogCollector 端口 [输出文件]</para>
+/// </summary>
+int _tmain(int argc, TCHAR* argv[]) {
+	if (argc < 2) {
+		std::cerr << "usage: LogCollector <port> [output.log]" << std::endl;
+		return 1;
+	}
+
+	const int nPort = _ttoi(argv[1]);
+	if (nPort <= 0 || nPort > 65535) {
+		std::cerr << "invalid port" << std::endl;
+		return 1;
+	}
+
+	FILE* pOutput = stdout;
+	if (argc > 2) {
+		if (_tfopen_s(&pOutput, argv[2], TEXT("ab")) != 0) {
+			std::cerr << "cannot open output file" << std::endl;
+			return 1;
+		}
+	} else {
+		_setmode(_fileno(stdout), _O_BINARY);
+	}
+
+	WSADATA wsaData;
+	if (::WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+		std::cerr << "cannot initialize winsock" << std::endl;
+		return 2;
+	}
+
+	const SOCKET sockListen = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	sockaddr_in addr {};
+	addr.sin_family      = AF_INET;
+	addr.sin_port        = ::htons(static_cast<u_short>(nPort));
+	addr.sin_addr.s_addr = ::htonl(INADDR_LOOPBACK);
+	if (sockListen == INVALID_SOCKET || ::bind(sockListen, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0
+	    || ::listen(sockListen, SOMAXCONN) != 0) {
+		std::cerr << "cannot listen on port " << nPort << std::endl;
+		::WSACleanup();
+		return 2;
+	}
+
+	std::cerr << "listening on 127.0.0.1:" << nPort << std::endl;
+	for (;;) {
+		const SOCKET sockClient = ::accept(sockListen, nullptr, nullptr);
+		if (sockClient == INVALID_SOCKET) {
+			break;
+		}
+		std::thread(&Serve, sockClient, pOutput).detach();
+	}
+
+	::closesocket(sockListen);
+	::WSACleanup();
+	return 0;
+}
\ No newline at end of file
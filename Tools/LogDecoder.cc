@@ -0,0 +1,267 @@
+#include <tchar.h>
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <unordered_map>
+#include <variant>
+
+#include "Exception.h"
+#include "Logger.h"
+
+using namespace Utils;
+
+namespace {
+	using ArgValue = std::variant<bool, TCHAR, int64_t, uint64_t, double, String>;
+
+	struct CallSite {
+		String strFuncName;
+		String strFormat;
+	};
+
+	/// <summary>
+	/// 从内存中顺序读取二进制日志的各个字段
+	/// </summary>
+	class ByteReader {
+	private:
+		const char* m_pCur_;
+		const char* m_pEnd_;
+
+	public:
+		ByteReader(const char* p_pBegin, const char* p_pEnd)
+		    : m_pCur_(p_pBegin)
+		    , m_pEnd_(p_pEnd) {
+		}
+
+		bool AtEnd() const noexcept {
+			return m_pCur_ >= m_pEnd_;
+		}
+
+		template <typename _Type>
+		_Type Read() {
+			if (static_cast<size_t>(m_pEnd_ - m_pCur_) < sizeof(_Type)) {
+				throw InvalidArgumentException(TEXT("日志文件已截断"));
+			}
+			_Type value;
+			std::memcpy(&value, m_pCur_, sizeof(_Type));
+			m_pCur_ += sizeof(_Type);
+			return value;
+		}
+
+		String ReadChars(size_t p_nCount) {
+			if (static_cast<size_t>(m_pEnd_ - m_pCur_) / sizeof(TCHAR) < p_nCount) {
+				throw InvalidArgumentException(TEXT("日志文件已截断"));
+			}
+			String strValue(p_nCount, TEXT('\0'));
+			std::memcpy(strValue.data(), m_pCur_, p_nCount * sizeof(TCHAR));
+			m_pCur_ += p_nCount * sizeof(TCHAR);
+			return strValue;
+		}
+
+		ByteReader Sub(size_t p_nSize) {
+			if (static_cast<size_t>(m_pEnd_ - m_pCur_) < p_nSize) {
+				throw InvalidArgumentException(TEXT("日志文件已截断"));
+			}
+			ByteReader reader(m_pCur_, m_pCur_ + p_nSize);
+			m_pCur_ += p_nSize;
+			return reader;
+		}
+	};
+
+	std::vector<ArgValue> DecodeArgs(ByteReader p_reader) {
+		using Arg = LogBinaryFormat::Arg;
+
+		std::vector<ArgValue> vArgs;
+		while (!p_reader.AtEnd()) {
+			switch (p_reader.Read<Arg>()) {
+				case Arg::BOOL:
+					vArgs.emplace_back(p_reader.Read<uint8_t>() != 0);
+					break;
+				case Arg::CHAR:
+					vArgs.emplace_back(p_reader.Read<TCHAR>());
+					break;
+				case Arg::INT:
+					vArgs.emplace_back(p_reader.Read<int64_t>());
+					break;
+				case Arg::UINT:
+					vArgs.emplace_back(p_reader.Read<uint64_t>());
+					break;
+				case Arg::DOUBLE:
+					vArgs.emplace_back(p_reader.Read<double>());
+					break;
+				case Arg::STRING:
+					vArgs.emplace_back(p_reader.ReadChars(p_reader.Read<uint32_t>()));
+					break;
+				default:
+					throw InvalidArgumentException(TEXT("未知的参数类型"));
+			}
+		}
+		return vArgs;
+	}
+
+	String FormatArg(const ArgValue& pc_arg, StringView p_svSpec) {
+		const String strFmt = FORMAT("{{:{}}}", p_svSpec);
+		return std::visit(
+		    [&strFmt](const auto& pc_value) {
+#ifdef _UNICODE
+			    return std::vformat(strFmt, std::make_wformat_args(pc_value));
+#else
+			    return std::vformat(strFmt, std::make_format_args(pc_value));
+#endif // _UNICODE
+		    },
+		    pc_arg);
+	}
+
+	/// <summary>
+	/// 按调用点的格式字符串逐个替换参数，与 std::format 的自动/手动编号规则一致
+	/// </summary>
+	String FormatMessage(const String& pc_strFormat, const std::vector<ArgValue>& pc_vArgs) {
+		String strMsg;
+		size_t nNextArg = 0;
+		for (size_t idx = 0; idx < pc_strFormat.size(); ++idx) {
+			const TCHAR ch = pc_strFormat[idx];
+			if ((ch == TEXT('{') || ch == TEXT('}')) && idx + 1 < pc_strFormat.size() && pc_strFormat[idx + 1] == ch) {
+				strMsg.push_back(ch);
+				++idx;
+				continue;
+			}
+			if (ch != TEXT('{')) {
+				strMsg.push_back(ch);
+				continue;
+			}
+
+			const size_t nClose = pc_strFormat.find(TEXT('}'), idx);
+			if (nClose == String::npos) {
+				throw InvalidArgumentException(TEXT("格式字符串无效"));
+			}
+
+			const StringView svField = StringView(pc_strFormat).substr(idx + 1, nClose - idx - 1);
+			const size_t nColon      = svField.find(TEXT(':'));
+			const StringView svId    = svField.substr(0, nColon);
+			const StringView svSpec  = nColon == StringView::npos ? StringView() : svField.substr(nColon + 1);
+
+			size_t nArg = nNextArg++;
+			if (!svId.empty()) {
+				nArg = StringUtils::ValueOf<size_t>(String(svId));
+			}
+			if (nArg >= pc_vArgs.size()) {
+				throw InvalidArgumentException(TEXT("参数个数与格式字符串不匹配"));
+			}
+
+			strMsg.append(FormatArg(pc_vArgs[nArg], svSpec));
+			idx = nClose;
+		}
+		return strMsg;
+	}
+
+	DateTime ToDateTime(int64_t p_nTicks, int64_t p_nTicksPerSecond) {
+		constexpr int64_t nNativeTicksPerSecond = Clock::period::den / Clock::period::num;
+		if (p_nTicksPerSecond == nNativeTicksPerSecond) {
+			return DateTime(Clock::duration(p_nTicks));
+		}
+		return DateTime(Clock::duration(static_cast<Clock::rep>(static_cast<long double>(p_nTicks) * nNativeTicksPerSecond / p_nTicksPerSecond)));
+	}
+
+	void Decode(const std::vector<char>& pc_vcData, std::ostream& p_os) {
+		using Entry = LogBinaryFormat::Entry;
+
+		ByteReader reader(pc_vcData.data(), pc_vcData.data() + pc_vcData.size());
+		for (char chMagic : LogBinaryFormat::MAGIC) {
+			if (reader.Read<char>() != chMagic) {
+				throw InvalidArgumentException(TEXT("不是二进制日志文件"));
+			}
+		}
+		if (reader.Read<uint32_t>() != sizeof(TCHAR)) {
+			throw InvalidArgumentException(TEXT("日志文件的字符宽度与当前程序不一致"));
+		}
+		const int64_t nTicksPerSecond = reader.Read<int64_t>();
+
+		std::unordered_map<uint32_t, CallSite> mpSites;
+		String strLine;
+		std::string strBytes;
+		while (!reader.AtEnd()) {
+			strLine.clear();
+			const Entry entry = reader.Read<Entry>();
+			if (entry == Entry {}) {
+				continue; // 旧版本未正常关闭时留下的预分配空白，其后可能还有重新打开后写入的记录
+			}
+
+			switch (entry) {
+				case Entry::SITE: {
+					const uint32_t nId   = reader.Read<uint32_t>();
+					String strFuncName   = reader.ReadChars(reader.Read<uint16_t>());
+					String strFormat     = reader.ReadChars(reader.Read<uint16_t>());
+					mpSites[nId]         = { std::move(strFuncName), std::move(strFormat) };
+					continue;
+				}
+				case Entry::RECORD: {
+					const uint32_t nId    = reader.Read<uint32_t>();
+					const int64_t nTicks  = reader.Read<int64_t>();
+					const auto level      = static_cast<LogLevel>(reader.Read<uint8_t>());
+					ByteReader argsReader = reader.Sub(reader.Read<uint32_t>());
+
+					const auto iter = mpSites.find(nId);
+					if (iter == mpSites.end()) {
+						throw InvalidArgumentException(TEXT("记录引用了未定义的调用点"));
+					}
+					Logger::FormatLine(strLine, ToDateTime(nTicks, nTicksPerSecond), level, iter->second.strFuncName.c_str(),
+					    FormatMessage(iter->second.strFormat, DecodeArgs(argsReader)));
+					break;
+				}
+				case Entry::MESSAGE: {
+					const int64_t nTicks = reader.Read<int64_t>();
+					const auto level     = static_cast<LogLevel>(reader.Read<uint8_t>());
+					String strFuncName   = reader.ReadChars(reader.Read<uint16_t>());
+					String strMsg        = reader.ReadChars(reader.Read<uint32_t>());
+					Logger::FormatLine(strLine, ToDateTime(nTicks, nTicksPerSecond), level, strFuncName.c_str(), strMsg);
+					break;
+				}
+				default:
+					throw InvalidArgumentException(TEXT("未知的记录类型"));
+			}
+
+#ifdef _UNICODE
+			strBytes.clear();
+			StringUtils::AppendUtf8(strBytes, strLine);
+			p_os.write(strBytes.data(), strBytes.size());
+#else
+			p_os << strLine;
+#endif // _UNICODE
+		}
+	}
+}
+
+/// <summary>
+/// 将 Logger 二进制模式生成的 .blog 文件还原为文本日志
+/// <para>用法：LogDecoder 输入文件 [输出文件]，未指定输出文件时写入同名的 .log 文件</para>
+/// </summary>
+int _tmain(int argc, TCHAR* argv[]) {
+	if (argc < 2) {
+		std::cerr << "usage: LogDecoder <input.blog> [output.log]" << std::endl;
+		return 1;
+	}
+
+	const std::filesystem::path pathInput(argv[1]);
+	std::filesystem::path pathOutput = argc > 2 ? std::filesystem::path(argv[2]) : std::filesystem::path(pathInput).replace_extension(TEXT(".log"));
+
+	std::ifstream ifs(pathInput, std::ios::binary);
+	if (!ifs.is_open()) {
+		std::cerr << "cannot open input file" << std::endl;
+		return 1;
+	}
+	const std::vector<char> vcData((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+	std::ofstream ofs(pathOutput);
+	if (!ofs.is_open()) {
+		std::cerr << "cannot open output file" << std::endl;
+		return 1;
+	}
+
+	try {
+		Decode(vcData, ofs);
+	} catch (const std::exception& ex) {
+		std::cerr << ex.what() << std::endl;
+		return 2;
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include <fcntl.h>
+#include <io.h>
+#include <tchar.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "Logger.h"
+
+using namespace Utils;
+
+namespace {
+	/// <summary>
+	/// 多线程写入时记录按入队顺序落盘，时间戳可能略有倒序，查询范围两端各放宽这么多
+	/// </summary>
+	constexpr auto MAX_SKEW = Seconds(1);
+
+	/// <summary>
+	/// 以只读方式映射整个日志文件，允许 Logger 同时继续写入
+	/// </summary>
+	class MappedFile {
+	private:
+		HANDLE m_hFile_      = INVALID_HANDLE_VALUE;
+		HANDLE m_hMapping_   = nullptr;
+		const char* m_pData_ = nullptr;
+		size_t m_nSize_      = 0;
+
+	public:
+		MappedFile()                             = default;
+		MappedFile(const MappedFile&)            = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		~MappedFile() {
+			if (m_pData_) {
+				::UnmapViewOfFile(m_pData_);
+			}
+			if (m_hMapping_) {
+				::CloseHandle(m_hMapping_);
+			}
+			if (m_hFile_ != INVALID_HANDLE_VALUE) {
+				::CloseHandle(m_hFile_);
+			}
+		}
+
+		bool Open(const std::filesystem::path& pc_path) {
+			m_hFile_ = ::CreateFile(pc_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+			    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (m_hFile_ == INVALID_HANDLE_VALUE) {
+				return false;
+			}
+
+			LARGE_INTEGER liSize {};
+			if (!::GetFileSizeEx(m_hFile_, &liSize)) {
+				return false;
+			}
+			m_nSize_ = static_cast<size_t>(liSize.QuadPart);
+			if (m_nSize_ == 0) {
+				return true; // 空文件无法映射
+			}
+
+			m_hMapping_ = ::CreateFileMapping(m_hFile_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!m_hMapping_) {
+				return false;
+			}
+			m_pData_ = static_cast<const char*>(::MapViewOfFile(m_hMapping_, FILE_MAP_READ, 0, 0, m_nSize_));
+			return m_pData_ != nullptr;
+		}
+
+		std::string_view GetData() const noexcept {
+			return m_pData_ ? std::string_view(m_pData_, m_nSize_) : std::string_view();
+		}
+	};
+
+	DateTime ToDateTime(int64_t p_nTicks, int64_t p_nTicksPerSecond) {
+		constexpr int64_t nNativeTicksPerSecond = Clock::period::den / Clock::period::num;
+		if (p_nTicksPerSecond == nNativeTicksPerSecond) {
+			return DateTime(Clock::duration(p_nTicks));
+		}
+		return DateTime(Clock::duration(static_cast<Clock::rep>(static_cast<long double>(p_nTicks) * nNativeTicksPerSecond / p_nTicksPerSecond)));
+	}
+
+	bool ParseNumber(std::string_view p_sv, size_t p_nPos, size_t p_nCount, int& p_nValue) {
+		if (p_sv.size() < p_nPos + p_nCount) {
+			return false;
+		}
+		p_nValue = 0;
+		for (size_t idx = p_nPos; idx < p_nPos + p_nCount; ++idx) {
+			if (p_sv[idx] < '0' || p_sv[idx] > '9') {
+				return false;
+			}
+			p_nValue = p_nValue * 10 + (p_sv[idx] - '0');
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// 解析"YYYY-MM-DD HH:MM:SS[.mmm]"，日期与时间之间也可以是'T'
+	/// </summary>
+	/// <returns>解析出的时间占用的字符数，失败时为0</returns>
+	size_t ParseTime(std::string_view p_sv, DateTime& p_dtTime) {
+		int nYear, nMonth, nDay, nHour, nMinute, nSecond, nMillis = 0;
+		if (p_sv.size() < 19 || !ParseNumber(p_sv, 0, 4, nYear) || p_sv[4] != '-' || !ParseNumber(p_sv, 5, 2, nMonth) || p_sv[7] != '-'
+		    || !ParseNumber(p_sv, 8, 2, nDay) || (p_sv[10] != ' ' && p_sv[10] != 'T') || !ParseNumber(p_sv, 11, 2, nHour) || p_sv[13] != ':'
+		    || !ParseNumber(p_sv, 14, 2, nMinute) || p_sv[16] != ':' || !ParseNumber(p_sv, 17, 2, nSecond)) {
+			return 0;
+		}
+
+		size_t nLength = 19;
+		if (p_sv.size() >= 23 && p_sv[19] == '.' && ParseNumber(p_sv, 20, 3, nMillis)) {
+			nLength = 23;
+		}
+
+		const std::chrono::year_month_day ymd { std::chrono::year(nYear), std::chrono::month(nMonth), std::chrono::day(nDay) };
+		if (!ymd.ok()) {
+			return 0;
+		}
+		p_dtTime = DateTime(std::chrono::local_days(ymd)) + Hours(nHour) + Minutes(nMinute) + Seconds(nSecond) + MilliSeconds(nMillis);
+		return nLength;
+	}
+
+	LogLevel ParseLevel(std::string_view p_svName) {
+		while (!p_svName.empty() && p_svName.back() == ' ') {
+			p_svName.remove_suffix(1);
+		}
+		if (p_svName == "trace") {
+			return LogLevel::TRACE;
+		}
+		if (p_svName == "debug") {
+			return LogLevel::DEBUG;
+		}
+		if (p_svName == "info") {
+			return LogLevel::INFO;
+		}
+		if (p_svName == "warn") {
+			return LogLevel::WARN;
+		}
+		if (p_svName == "error") {
+			return LogLevel::ERR;
+		}
+		return LogLevel::NONE;
+	}
+
+	/// <summary>
+	/// 解析一条记录的开头，支持文本格式"[时间] [级别]"与 JSON Lines 格式{"time":"...","level":"..."}
+	/// </summary>
+	/// <returns>该行是否为一条记录的开头，否则为上一条记录的续行</returns>
+	bool ParseRecordHead(std::string_view p_svLine, DateTime& p_dtTime, LogLevel& p_level) {
+		constexpr std::string_view svJsonTime  = "{\"time\":\"";
+		constexpr std::string_view svJsonLevel = "\",\"level\":\"";
+
+		if (p_svLine.starts_with('[')) {
+			const size_t nLength = ParseTime(p_svLine.substr(1), p_dtTime);
+			if (nLength == 0 || p_svLine.substr(1 + nLength).substr(0, 3) != "] [") {
+				return false;
+			}
+			const std::string_view svRest = p_svLine.substr(nLength + 4);
+			p_level                       = ParseLevel(svRest.substr(0, svRest.find(']')));
+			return true;
+		}
+
+		if (p_svLine.starts_with(svJsonTime)) {
+			const size_t nLength          = ParseTime(p_svLine.substr(svJsonTime.size()), p_dtTime);
+			const std::string_view svRest = p_svLine.substr(svJsonTime.size() + nLength);
+			if (nLength == 0 || !svRest.starts_with(svJsonLevel)) {
+				return false;
+			}
+			const std::string_view svLevel = svRest.substr(svJsonLevel.size());
+			p_level                        = ParseLevel(svLevel.substr(0, svLevel.find('"')));
+			return true;
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// 在时间索引中找到开始扫描的偏移，索引不存在或无效时从头扫描
+	/// </summary>
+	uint64_t FindStartOffset(const std::filesystem::path& pc_pathIndex, const DateTime& pc_dtFrom) {
+		std::ifstream ifs(pc_pathIndex, std::ios::binary);
+		if (!ifs.is_open()) {
+			std::cerr << "index not found, scanning the whole file" << std::endl;
+			return 0;
+		}
+
+		char szMagic[sizeof(LogIndexFormat::MAGIC)] {};
+		int64_t nTicksPerSecond = 0;
+		ifs.read(szMagic, sizeof(szMagic));
+		ifs.read(reinterpret_cast<char*>(&nTicksPerSecond), sizeof(nTicksPerSecond));
+		if (!ifs || std::memcmp(szMagic, LogIndexFormat::MAGIC, sizeof(szMagic)) != 0 || nTicksPerSecond <= 0) {
+			std::cerr << "invalid index, scanning the whole file" << std::endl;
+			return 0;
+		}
+
+		std::vector<LogIndexFormat::Entry> vEntries;
+		LogIndexFormat::Entry entry;
+		while (ifs.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+			vEntries.push_back(entry);
+		}
+
+		// 最后一个早于查询起点的索引项之后的记录才可能落在范围内
+		const DateTime dtBegin = pc_dtFrom - MAX_SKEW;
+		const auto fnBefore    = [&](const LogIndexFormat::Entry& pc_entry) { return ToDateTime(pc_entry.nTicks, nTicksPerSecond) < dtBegin; };
+		const auto iter        = std::partition_point(vEntries.begin(), vEntries.end(), fnBefore);
+		return iter == vEntries.begin() ? 0 : std::prev(iter)->nOffset;
+	}
+
+	void Query(std::string_view p_svData, uint64_t p_nOffset, const DateTime& pc_dtFrom, const DateTime& pc_dtTo, LogLevel p_minLevel, std::ostream& p_os) {
+		const DateTime dtStop = pc_dtTo + MAX_SKEW;
+
+		// 索引偏移指向某条记录的开头，文件被截断或替换后偏移可能越界，此时从头扫描
+		size_t nPos    = p_nOffset <= p_svData.size() ? static_cast<size_t>(p_nOffset) : 0;
+		bool bMatching = false;
+		while (nPos < p_svData.size() && p_svData[nPos] != '\0') {
+			const size_t nEnd             = p_svData.find('\n', nPos);
+			const size_t nNext            = nEnd == std::string_view::npos ? p_svData.size() : nEnd + 1;
+			const std::string_view svLine = p_svData.substr(nPos, nNext - nPos);
+
+			DateTime dtTime;
+			LogLevel level;
+			if (ParseRecordHead(svLine, dtTime, level)) {
+				if (dtTime > dtStop) {
+					break;
+				}
+				bMatching = pc_dtFrom <= dtTime && dtTime <= pc_dtTo && level >= p_minLevel;
+			}
+			if (bMatching) {
+				p_os.write(svLine.data(), svLine.size());
+			}
+			nPos = nNext;
+		}
+	}
+
+	std::string ToNarrow(const TCHAR* p_cszArg) {
+		std::string strValue;
+		for (; *p_cszArg; ++p_cszArg) {
+			strValue.push_back(static_cast<char>(*p_cszArg));
+		}
+		return strValue;
+	}
+}
+
+/// <summary>
+/// 按时间范围与最低级别查询 Logger 生成的文本或 JSON Lines 日志，借助 IndexInterval 生成的 .idx 索引跳过范围之前的内容
+/// <para>用法：LogQuery 日志文件 起始时间 结束时间 [--level 级别]，时间格式为"YYYY-MM-DD HH:MM:SS[.mmm]"，匹配的记录原样写入标准输出</para>
+/// </summary>
+int _tmain(int argc, TCHAR* argv[]) {
+	if (argc != 4 && !(argc == 6 && _tcscmp(argv[4], TEXT("--level")) == 0)) {
+		std::cerr << "usage: LogQuery <file.log> <from> <to> [--level trace|debug|info|warn|error]" << std::endl;
+		return 1;
+	}
+
+	DateTime dtFrom, dtTo;
+	const std::string strFrom = ToNarrow(argv[2]);
+	const std::string strTo   = ToNarrow(argv[3]);
+	if (ParseTime(strFrom, dtFrom) != strFrom.size() || ParseTime(strTo, dtTo) != strTo.size()) {
+		std::cerr << "invalid time, expected YYYY-MM-DD HH:MM:SS[.mmm]" << std::endl;
+		return 1;
+	}
+
+	LogLevel minLevel = LogLevel::TRACE;
+	if (argc == 6) {
+		minLevel = ParseLevel(ToNarrow(argv[5]));
+		if (minLevel == LogLevel::NONE) {
+			std::cerr << "invalid level" << std::endl;
+			return 1;
+		}
+	}
+
+	const std::filesystem::path pathLog(argv[1]);
+	MappedFile file;
+	if (!file.Open(pathLog)) {
+		std::cerr << "cannot open log file" << std::endl;
+		return 1;
+	}
+
+	std::filesystem::path pathIndex = pathLog;
+	pathIndex += LogIndexFormat::FILE_EXTENSION;
+	const uint64_t nOffset = FindStartOffset(pathIndex, dtFrom);
+
+	// 记录原样输出，不做换行转换
+	_setmode(_fileno(stdout), _O_BINARY);
+	Query(file.GetData(), nOffset, dtFrom, dtTo, minLevel, std::cout);
+	std::cout.flush();
+	return 0;
+}
\ No newline at end of file
@@ -54,7 +54,7 @@ StringList DeviceUtils::GetWmiQueryResult_(String p_strQuery, String p_strPropNa
 		::VariantInit(&vtProp);
 		hRes = pObj->Get(p_strPropName.c_str(), 0, &vtProp, NULL, NULL);
 		if (nullptr != vtProp.bstrVal) {
-			vstrRes.push_back(StringUtils::Trim(vtProp.bstrVal));
+			vstrRes.emplace_back(StringUtils::TrimView(vtProp.bstrVal));
 		}
 		::VariantClear(&vtProp);
 	}
@@ -32,7 +32,8 @@ UTILS_API const TCHAR* GetComError(HRESULT p_hRes, IErrorInfo* p_pErrInfo) {
 	}
 
 	if (ERROR_SUCCESS != p_hRes) {
-		String&& msg = StringUtils::Trim(GetErrorString(p_hRes), { String(TEXT("。")) });
+		String msg = GetErrorString(p_hRes);
+		StringUtils::TrimInPlace(msg, { TEXT("。") });
 		s_strEntirely += FORMAT("{}(0x{:X})", msg, (unsigned long)p_hRes);
 	}
 
@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+
+#include "Exception.h"
+
+_UTILS_BEGIN
+
+/// <summary>
+/// 内置的快速无损压缩，采用LZ4块格式，无需依赖外部库
+/// </summary>
+class UTILS_API CompressionUtils {
+public:
+	/// <summary>
+	/// 压缩文件的扩展名
+	/// </summary>
+	static constexpr const TCHAR* FILE_EXTENSION = TEXT(".ulz");
+
+	/// <summary>
+	/// 压缩给定的数据块
+	/// </summary>
+	/// <param name="p_pData">将要压缩的数据</param>
+	/// <param name="p_nSize">数据的字节数</param>
+	/// <returns>LZ4块格式的压缩数据</returns>
+	static std::vector<byte> Compress(const byte* p_pData, size_t p_nSize);
+
+	/// <summary>
+	/// 解压由Compress生成的数据块
+	/// </summary>
+	/// <param name="p_pData">压缩数据</param>
+	/// <param name="p_nSize">压缩数据的字节数</param>
+	/// <param name="p_nRawSize">原始数据的字节数</param>
+	/// <exception cref="InvalidArgumentException">压缩数据损坏时抛出</exception>
+	/// <returns>解压后的数据</returns>
+	static std::vector<byte> Decompress(const byte* p_pData, size_t p_nSize, size_t p_nRawSize);
+
+	/// <summary>
+	/// 分块压缩给定文件，写入目标文件
+	/// </summary>
+	/// <param name="pc_strSrcPath">源文件路径</param>
+	/// <param name="pc_strDstPath">目标文件路径</param>
+	/// <returns>是否成功</returns>
+	static bool CompressFile(const String& pc_strSrcPath, const String& pc_strDstPath);
+
+	/// <summary>
+	/// 解压由CompressFile生成的文件，写入目标文件
+	/// </summary>
+	/// <param name="pc_strSrcPath">压缩文件路径</param>
+	/// <param name="pc_strDstPath">目标文件路径</param>
+	/// <exception cref="InvalidArgumentException">压缩文件损坏时抛出</exception>
+	/// <returns>是否成功</returns>
+	static bool DecompressFile(const String& pc_strSrcPath, const String& pc_strDstPath);
+};
+
+_UTILS_END
\ No newline at end of file
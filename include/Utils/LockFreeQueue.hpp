@@ -0,0 +1,176 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+#include "utils_def.h"
+
+_UTILS_BEGIN
+
+/// <summary>
+/// 有界无锁队列，支持多生产者与多消费者，基于带序号的环形缓冲区实现
+/// </summary>
+/// <typeparam name="_Type">元素类型，需可默认构造与移动赋值</typeparam>
+template <typename _Type>
+class LockFreeQueue {
+private:
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	struct Cell {
+		std::atomic<size_t> nSequence;
+		_Type value;
+	};
+
+	std::unique_ptr<Cell[]> m_pCells_;
+	size_t m_nMask_;
+
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_nEnqueuePos_ { 0 };
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_nDequeuePos_ { 0 };
+
+public:
+	/// <summary>
+	/// 创建指定容量的队列，实际容量向上取整为2的幂
+	/// </summary>
+	/// <param name="p_nCapacity">队列容量</param>
+	explicit LockFreeQueue(size_t p_nCapacity)
+	    : m_pCells_(std::make_unique<Cell[]>(std::bit_ceil(p_nCapacity < 2 ? size_t(2) : p_nCapacity)))
+	    , m_nMask_(std::bit_ceil(p_nCapacity < 2 ? size_t(2) : p_nCapacity) - 1) {
+		for (size_t idx = 0; idx <= m_nMask_; ++idx) {
+			m_pCells_[idx].nSequence.store(idx, std::memory_order_relaxed);
+		}
+	}
+
+	LockFreeQueue(const LockFreeQueue&)            = delete;
+	LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+	/// <summary>
+	/// 尝试将元素放入队列，仅在成功时移动给定的元素
+	/// </summary>
+	/// <param name="p_value">将要放入的元素</param>
+	/// <returns>队列已满时返回false</returns>
+	bool TryPush(_Type&& p_value) {
+		size_t nPos = m_nEnqueuePos_.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell& cell     = m_pCells_[nPos & m_nMask_];
+			size_t nSeq    = cell.nSequence.load(std::memory_order_acquire);
+			intptr_t nDiff = static_cast<intptr_t>(nSeq) - static_cast<intptr_t>(nPos);
+
+			if (nDiff == 0) {
+				if (m_nEnqueuePos_.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed)) {
+					cell.value = std::move(p_value);
+					cell.nSequence.store(nPos + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (nDiff < 0) {
+				return false;
+			} else {
+				nPos = m_nEnqueuePos_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// <summary>
+	/// 尝试占用队尾的一格，并由回调就地写入该格中的元素。元素保留上次使用时的容量，反复使用同一批缓冲时不再分配内存
+	/// </summary>
+	/// <param name="p_fnFill">以元素的引用调用的回调，不得抛出异常</param>
+	/// <returns>队列已满时返回false，此时不调用回调</returns>
+	template <typename _FnT>
+	bool TryPushWith(_FnT&& p_fnFill) noexcept {
+		size_t nPos = m_nEnqueuePos_.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell& cell     = m_pCells_[nPos & m_nMask_];
+			size_t nSeq    = cell.nSequence.load(std::memory_order_acquire);
+			intptr_t nDiff = static_cast<intptr_t>(nSeq) - static_cast<intptr_t>(nPos);
+
+			if (nDiff == 0) {
+				if (m_nEnqueuePos_.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed)) {
+					p_fnFill(cell.value);
+					cell.nSequence.store(nPos + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (nDiff < 0) {
+				return false;
+			} else {
+				nPos = m_nEnqueuePos_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// <summary>
+	/// 尝试取出队列头部的元素，由回调就地读取，元素仍留在格中以便复用其缓冲
+	/// </summary>
+	/// <param name="p_fnRead">以元素的引用调用的回调，不得抛出异常</param>
+	/// <returns>队列为空时返回false，此时不调用回调</returns>
+	template <typename _FnT>
+	bool TryPopWith(_FnT&& p_fnRead) noexcept {
+		size_t nPos = m_nDequeuePos_.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell& cell     = m_pCells_[nPos & m_nMask_];
+			size_t nSeq    = cell.nSequence.load(std::memory_order_acquire);
+			intptr_t nDiff = static_cast<intptr_t>(nSeq) - static_cast<intptr_t>(nPos + 1);
+
+			if (nDiff == 0) {
+				if (m_nDequeuePos_.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed)) {
+					p_fnRead(cell.value);
+					cell.nSequence.store(nPos + m_nMask_ + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (nDiff < 0) {
+				return false;
+			} else {
+				nPos = m_nDequeuePos_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// <summary>
+	/// 尝试从队列头部取出元素
+	/// </summary>
+	/// <param name="p_value">取出的元素</param>
+	/// <returns>队列为空时返回false</returns>
+	bool TryPop(_Type& p_value) {
+		size_t nPos = m_nDequeuePos_.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell& cell     = m_pCells_[nPos & m_nMask_];
+			size_t nSeq    = cell.nSequence.load(std::memory_order_acquire);
+			intptr_t nDiff = static_cast<intptr_t>(nSeq) - static_cast<intptr_t>(nPos + 1);
+
+			if (nDiff == 0) {
+				if (m_nDequeuePos_.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed)) {
+					p_value = std::move(cell.value);
+					cell.nSequence.store(nPos + m_nMask_ + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (nDiff < 0) {
+				return false;
+			} else {
+				nPos = m_nDequeuePos_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// <summary>
+	/// 判断队列头部是否没有已发布的元素
+	/// </summary>
+	bool Empty() const noexcept {
+		size_t nPos = m_nDequeuePos_.load(std::memory_order_acquire);
+		return m_pCells_[nPos & m_nMask_].nSequence.load(std::memory_order_acquire) != nPos + 1;
+	}
+
+	/// <summary>
+	/// 获取队列的实际容量
+	/// </summary>
+	size_t GetCapacity() const noexcept {
+		return m_nMask_ + 1;
+	}
+
+	/// <summary>
+	/// 获取至今为止进入队列的元素总数
+	/// </summary>
+	size_t GetPushedCount() const noexcept {
+		return m_nEnqueuePos_.load(std::memory_order_acquire);
+	}
+};
+
+_UTILS_END
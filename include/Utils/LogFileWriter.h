@@ -0,0 +1,156 @@
+#pragma once
+#include "StringUtils.h"
+
+#pragma warning(push)
+#pragma warning(disable : 4251)
+
+_UTILS_BEGIN
+
+/// <summary>
+/// 日志文件的底层写入器，只负责以追加方式写入字节
+/// </summary>
+class UTILS_API LogFileWriter {
+public:
+	virtual ~LogFileWriter() = default;
+
+	/// <summary>
+	/// 以追加方式打开文件，已打开的文件会先被关闭
+	/// </summary>
+	/// <param name="pc_strPath">文件路径</param>
+	/// <param name="p_bBinary">是否按二进制写入，否则按文本模式转换换行符</param>
+	/// <returns>是否成功</returns>
+	virtual bool Open(const String& pc_strPath, bool p_bBinary) = 0;
+
+	/// <summary>
+	/// 关闭文件
+	/// </summary>
+	virtual void Close() = 0;
+
+	/// <summary>
+	/// 文件是否已打开
+	/// </summary>
+	virtual bool IsOpen() const noexcept = 0;
+
+	/// <summary>
+	/// 在文件末尾追加数据
+	/// </summary>
+	/// <param name="p_pData">数据</param>
+	/// <param name="p_nSize">数据的字节数</param>
+	/// <returns>是否成功</returns>
+	virtual bool Write(const char* p_pData, size_t p_nSize) = 0;
+
+	/// <summary>
+	/// 将已写入的数据交给操作系统，使其对其他进程可见
+	/// </summary>
+	virtual void Flush() = 0;
+
+	/// <summary>
+	/// 将已写入的数据交给操作系统并等待其落盘，返回后即使系统掉电也不会丢失
+	/// </summary>
+	/// <returns>是否成功</returns>
+	virtual bool Sync() = 0;
+
+	/// <summary>
+	/// 文件当前的有效长度
+	/// </summary>
+	virtual size_t GetSize() const noexcept = 0;
+};
+
+/// <summary>
+/// 带用户态缓冲的写入器，Flush 时以一次 WriteFile 追加缓冲中的全部数据
+/// </summary>
+class UTILS_API BufferedLogFileWriter : public LogFileWriter {
+private:
+	HANDLE m_hFile_ = INVALID_HANDLE_VALUE;
+	std::string m_strBuffer_;
+	size_t m_nSize_ = 0;
+	bool m_bBinary_ = false;
+
+public:
+	/// <summary>
+	/// 缓冲区达到此大小时自动交给操作系统
+	/// </summary>
+	static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+	BufferedLogFileWriter() = default;
+	BufferedLogFileWriter(const BufferedLogFileWriter&)            = delete;
+	BufferedLogFileWriter& operator=(const BufferedLogFileWriter&) = delete;
+	~BufferedLogFileWriter() override;
+
+	bool Open(const String& pc_strPath, bool p_bBinary) override;
+	void Close() override;
+	bool Write(const char* p_pData, size_t p_nSize) override;
+	void Flush() override;
+	bool Sync() override;
+
+	inline bool IsOpen() const noexcept override {
+		return m_hFile_ != INVALID_HANDLE_VALUE;
+	}
+
+	inline size_t GetSize() const noexcept override {
+		return m_nSize_;
+	}
+};
+
+/// <summary>
+/// 基于内存映射的写入器，文件按固定大小的块预先分配，写入即复制到映射区域，由操作系统在后台落盘。
+/// <para>进程崩溃时已复制到映射区域的数据不会丢失，关闭时文件被截断为实际长度；</para>
+/// <para>未正常关闭的文件在下次打开时会去掉末尾的预分配空白：文本文件去掉末尾所有的'\0'；
+/// 二进制文件的记录本身可能以'\0'结尾，由构造时给定的函数按格式找出有效长度，未给定时同样去掉末尾所有的'\0'</para>
+/// </summary>
+class UTILS_API MappedLogFileWriter : public LogFileWriter {
+public:
+	/// <summary>
+	/// 由文件的全部内容得出其中完整记录的总长度，用于截掉二进制文件末尾的预分配空白
+	/// </summary>
+	using ValidLengthFn = size_t (*)(const char* p_pData, size_t p_nSize) noexcept;
+
+private:
+	HANDLE m_hFile_    = INVALID_HANDLE_VALUE;
+	HANDLE m_hMapping_ = NULL;
+	char* m_pView_     = nullptr;
+
+	size_t m_nChunkSize_;
+	ValidLengthFn m_fnValidLength_;
+	size_t m_nCapacity_ = 0;
+	size_t m_nSize_     = 0;
+	bool m_bBinary_     = false;
+
+private:
+	bool Map_(size_t p_nCapacity);
+	void Unmap_() noexcept;
+
+public:
+	/// <summary>
+	/// 默认的预分配块大小
+	/// </summary>
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 4 * 1024 * 1024;
+
+	/// <summary>
+	/// 创建内存映射写入器
+	/// </summary>
+	/// <param name="p_nChunkSize">文件每次增长的字节数</param>
+	/// <param name="p_fnValidLength">二进制文件的有效长度，为空时去掉末尾所有的'\0'</param>
+	explicit MappedLogFileWriter(size_t p_nChunkSize = DEFAULT_CHUNK_SIZE, ValidLengthFn p_fnValidLength = nullptr);
+	MappedLogFileWriter(const MappedLogFileWriter&)            = delete;
+	MappedLogFileWriter& operator=(const MappedLogFileWriter&) = delete;
+	~MappedLogFileWriter() override;
+
+	bool Open(const String& pc_strPath, bool p_bBinary) override;
+	void Close() override;
+	bool Write(const char* p_pData, size_t p_nSize) override;
+	void Flush() override;
+	bool Sync() override;
+
+	inline bool IsOpen() const noexcept override {
+		return m_hFile_ != INVALID_HANDLE_VALUE;
+	}
+
+	inline size_t GetSize() const noexcept override {
+		return m_nSize_;
+	}
+};
+
+_UTILS_END
+
+#pragma warning(pop)
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <memory>
+
+#include "DateTimeUtils.h"
+#include "LogLevel.h"
+#include "StringUtils.h"
+
+#pragma warning(push)
+#pragma warning(disable : 4251)
+
+_UTILS_BEGIN
+
+/// <summary>
+/// 在内存中以固定大小的无锁环形缓冲保留最近的记录，包括低于文件级别的 TRACE/DEBUG 记录。
+/// <para>进程调用 std::terminate、因 abort 或未处理的结构化异常退出时，所有记录器会自动写出到各自的转储文件，也可随时手动转储</para>
+/// </summary>
+class UTILS_API LogFlightRecorder {
+public:
+	/// <summary>
+	/// 单条记录保留的最大字符数，超出部分被截断
+	/// </summary>
+	static constexpr size_t MESSAGE_CAPACITY = 240;
+
+private:
+	/// <summary>
+	/// 环中的一格，以顺序锁保护：写入期间 nSeq 为奇数，写完后为 2 * (记录序号 + 1)。
+	/// <para>写入前以 CAS 占用该格，绕环一圈后落到同一格的两个线程只有一个能写入</para>
+	/// </summary>
+	struct alignas(64) Slot_ {
+		std::atomic<uint64_t> nSeq { 0 };
+		DateTime dtTime {};
+		LogLevel level = LogLevel::NONE;
+		const TCHAR* pcszFuncName = nullptr;
+		size_t nLength = 0;
+		TCHAR szMsg[MESSAGE_CAPACITY] {};
+	};
+
+	/// <summary>
+	/// 转储时使用的缓冲，创建时预先分配，转储过程中不再分配内存
+	/// </summary>
+	struct DumpBuffer_;
+
+	std::unique_ptr<Slot_[]> m_pSlots_;
+	size_t m_nMask_;
+	std::atomic<uint64_t> m_nHead_ { 0 };
+	String m_strDumpPath_;
+	std::unique_ptr<DumpBuffer_> m_pDumpBuffer_;
+	mutable std::atomic_flag m_bDumping_;
+
+	/// <summary>
+	/// 所有存活的记录器组成的链表中的下一个，记录器的个数不受限制
+	/// </summary>
+	std::atomic<LogFlightRecorder*> m_pNext_ { nullptr };
+
+public:
+	/// <summary>
+	/// 创建飞行记录器并登记到崩溃时的转储列表。第一个记录器登记时安装 terminate、SIGABRT 与未处理异常的处理函数，
+	/// 转储后转交原处理函数；最后一个记录器析构时恢复原处理函数
+	/// </summary>
+	/// <param name="p_nCapacity">保留的记录数，向上取整为2的幂</param>
+	/// <param name="pc_strDumpPath">转储文件的路径，所在目录在此时创建</param>
+	LogFlightRecorder(size_t p_nCapacity, const String& pc_strDumpPath);
+	LogFlightRecorder(const LogFlightRecorder&)            = delete;
+	LogFlightRecorder& operator=(const LogFlightRecorder&) = delete;
+	~LogFlightRecorder();
+
+	DECLARE_READONLY_PROPERTY_WITH_BODY(String, DumpPath, m_strDumpPath_);
+
+	/// <summary>
+	/// 记录一条消息，可被多个线程同时调用
+	/// </summary>
+	/// <param name="pc_dtTime">记录时间</param>
+	/// <param name="p_level">记录级别</param>
+	/// <param name="p_cszFuncName">函数名，需具有静态生存期</param>
+	/// <param name="p_svMsg">消息</param>
+	void Record(const DateTime& pc_dtTime, LogLevel p_level, const TCHAR* p_cszFuncName, StringView p_svMsg) noexcept;
+
+	/// <summary>
+	/// 将当前保留的记录按由旧到新的顺序写入转储文件，文件已存在时被覆盖
+	/// </summary>
+	/// <returns>是否成功</returns>
+	bool Dump() const noexcept;
+
+	/// <summary>
+	/// 将当前保留的记录按由旧到新的顺序写入给定文件，文件已存在时被覆盖。
+	/// <para>崩溃时也由此转储：只使用预先分配的缓冲与 Win32 文件接口，不分配内存、不加锁；同一记录器同时只能有一次转储，其余调用直接失败</para>
+	/// </summary>
+	/// <param name="pc_strPath">文件路径，所在目录需已存在</param>
+	/// <returns>是否成功</returns>
+	bool Dump(const String& pc_strPath) const noexcept;
+
+	/// <summary>
+	/// 转储所有存活的飞行记录器
+	/// </summary>
+	static void DumpAll() noexcept;
+};
+
+_UTILS_END
+
+#pragma warning(pop)
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+#include "utils_def.h"
+
+_UTILS_BEGIN
+
+enum class UTILS_API LogLevel {
+	NONE,
+	TRACE,
+	DEBUG,
+	INFO,
+	WARN,
+	ERR,
+};
+
+#ifdef _DEBUG
+#define DEFAULT_LOG_LEVEL LogLevel::DEBUG
+#else
+#define DEFAULT_LOG_LEVEL LogLevel::INFO
+#endif // DEBUG
+
+_UTILS_END
\ No newline at end of file
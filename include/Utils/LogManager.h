@@ -0,0 +1,266 @@
+#pragma once
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "DateTimeUtils.h"
+#include "LogFileWriter.h"
+#include "LogLevel.h"
+#include "Singletons.hpp"
+#include "StringUtils.h"
+
+#pragma warning(push)
+#pragma warning(disable : 4251 4275)
+
+_UTILS_BEGIN
+
+class Logger;
+class LogRateLimiter;
+class LogSiteGate;
+
+/// <summary>
+/// 调用点的开关
+/// </summary>
+enum class LogSiteMode : uint8_t {
+	/// <summary>
+	/// 按所绑定 Logger 的级别决定
+	/// </summary>
+	DEFAULT,
+	ENABLED,
+	DISABLED,
+};
+
+/// <summary>
+/// 调用点的快照
+/// </summary>
+struct LogSiteInfo {
+	uint32_t nId;
+	LogLevel level;
+	LPCTSTR pcszFuncName;
+	LPCTSTR pcszFile;
+	uint32_t nLine;
+	LogSiteMode mode;
+
+	/// <summary>
+	/// 对最近绑定的 Logger 是否启用
+	/// </summary>
+	bool bEnabled;
+};
+
+/// <summary>
+/// 日志文件的落盘策略。除 NONE 外，错误级别的记录总会在返回前落盘
+/// </summary>
+enum class UTILS_API LogDurability {
+	/// <summary>
+	/// 只将数据交给操作系统，不主动落盘
+	/// </summary>
+	NONE,
+
+	/// <summary>
+	/// 每写入 SyncEveryN 条记录落盘一次
+	/// </summary>
+	FLUSH_EVERY_N,
+
+	/// <summary>
+	/// 写入时距上次落盘超过 SyncIntervalMs 毫秒则落盘
+	/// </summary>
+	FLUSH_EVERY_MS,
+
+	/// <summary>
+	/// 仅在写入错误级别的记录时落盘
+	/// </summary>
+	SYNC_ON_ERROR,
+};
+
+/// <summary>
+/// 一个物理日志文件的写入状态，由所有写入同一目录、同一名称、同一格式的 Logger 共享。
+/// <para>除 mtxCommit、cvCommit、nCommitted、bCommitting 外的成员均由 mtxWrite 保护</para>
+/// </summary>
+struct SharedLogFile {
+	/// <summary>
+	/// 串行化对日志文件的写入
+	/// </summary>
+	std::mutex mtxWrite;
+
+	/// <summary>
+	/// 当前打开的日志文件，跨记录保持打开，仅在日期变化或达到大小上限时切换。由首个打开文件的 Logger 按其设置创建
+	/// </summary>
+	std::unique_ptr<LogFileWriter> pWriter;
+
+	/// <summary>
+	/// 文件相关的设置，由首个打开文件的 Logger 在创建 pWriter 时写入，此后共用该文件的所有 Logger 只读取这里的值
+	/// </summary>
+	bool bMappedFile         = false;
+	LogDurability durability = LogDurability::NONE;
+	size_t nSyncEveryN       = 0;
+	size_t nSyncIntervalMs   = 0;
+	size_t nIndexInterval    = 0;
+	size_t nMaxFileSize      = 0;
+	size_t nMaxFileCount     = 0;
+	size_t nMaxTotalSize     = 0;
+	bool bCompressRotated    = false;
+
+	/// <summary>
+	/// 本进程是否尚未向该文件写入过记录
+	/// </summary>
+	bool bFirstLog = true;
+
+	/// <summary>
+	/// 当前文件中已写入定义的调用点，按调用点编号索引
+	/// </summary>
+	std::vector<bool> vbSitesWritten;
+
+	/// <summary>
+	/// 当前日志文件的完整路径、失效的时间点及在当天的分段序号
+	/// </summary>
+	String strFullFilePath;
+	DateTime dtNextMidnight {};
+	size_t nSegment = 0;
+
+	/// <summary>
+	/// 当前日志文件的时间索引，未启用索引时为空；nUnindexed 为上次登记后写入的记录数
+	/// </summary>
+	std::unique_ptr<BufferedLogFileWriter> pIndex;
+	size_t nUnindexed = 0;
+
+	/// <summary>
+	/// 上次落盘后写入的记录数及上次落盘的时间
+	/// </summary>
+	size_t nUnsynced = 0;
+	std::chrono::steady_clock::time_point tpLastSync {};
+
+	/// <summary>
+	/// 同步模式下的组提交：nWritten 为已写入记录的序号；
+	/// nCommitted 为已落盘的序号，同一时刻只有一个线程执行落盘，其余线程等待其结果
+	/// </summary>
+	uint64_t nWritten = 0;
+	std::mutex mtxCommit;
+	std::condition_variable cvCommit;
+	uint64_t nCommitted = 0;
+	bool bCommitting    = false;
+};
+
+/// <summary>
+/// 进程级的日志管理器：
+/// <para>为每个物理日志文件维护唯一的 SharedLogFile，使指向同一文件的多个 Logger 共用同一个写入器，而不是各自打开文件后交错写入；</para>
+/// <para>登记所有存活的 Logger，按监视的配置文件在运行时修改各 Logger 的级别；</para>
+/// <para>登记所有调用点，在级别变化时更新其启用状态，并可单独切换</para>
+/// </summary>
+class UTILS_API LogManager : public Singleton<LogManager> {
+	friend class Singleton<LogManager>;
+	friend class Logger;
+	friend class LogRateLimiter;
+	friend class LogSiteGate;
+
+private:
+	std::mutex m_mtxFiles_;
+
+	/// <summary>
+	/// 以规范化后的目录、名称与扩展名为键，最后一个 Logger 释放后文件随之关闭
+	/// </summary>
+	std::unordered_map<String, std::weak_ptr<SharedLogFile>> m_mapFiles_;
+
+	/// <summary>
+	/// 存活的 Logger 及配置文件中的级别，均由 m_mtxLoggers_ 保护。键"*"表示未单独配置的 Logger 的级别
+	/// </summary>
+	std::mutex m_mtxLoggers_;
+	std::vector<Logger*> m_vLoggers_;
+	std::unordered_map<String, LogLevel> m_mapLevels_;
+
+	/// <summary>
+	/// 配置文件的监视线程
+	/// </summary>
+	std::mutex m_mtxWatch_;
+	std::thread m_thWatcher_;
+	HANDLE m_hStopEvent_ = nullptr;
+	String m_strConfigPath_;
+
+	/// <summary>
+	/// 所有存活的调用点，由 m_mtxSites_ 保护
+	/// </summary>
+	std::mutex m_mtxSites_;
+	std::vector<LogSiteGate*> m_vSites_;
+	uint32_t m_nNextSiteId_ = 0;
+
+	/// <summary>
+	/// 所有存活的限流器，由 m_mtxLimiters_ 保护
+	/// </summary>
+	std::mutex m_mtxLimiters_;
+	std::vector<LogRateLimiter*> m_vLimiters_;
+
+	LogManager() = default;
+
+	void Register_(Logger* p_pLogger);
+	void Unregister_(Logger* p_pLogger);
+	void RegisterSite_(LogSiteGate* p_pSite);
+	void UnregisterSite_(LogSiteGate* p_pSite);
+	bool BindSite_(LogSiteGate* p_pSite, const Logger* p_pLogger);
+	void RefreshSites_(const Logger* p_pLogger);
+	void UnbindSites_(const Logger* p_pLogger);
+	void RegisterLimiter_(LogRateLimiter* p_pLimiter);
+	void UnregisterLimiter_(LogRateLimiter* p_pLimiter);
+	void FlushSuppressed_(const Logger* p_pLogger);
+	void UnbindLimiters_(const Logger* p_pLogger);
+	void WatchLoop_(String p_strPath, HANDLE p_hStopEvent);
+	std::optional<LogLevel> FindLevel_(const String& pc_strName) const;
+
+public:
+	~LogManager() override;
+
+	/// <summary>
+	/// 获取给定日志文件的共享写入状态，不存在时创建
+	/// </summary>
+	/// <param name="pc_strDirectory">日志所在目录</param>
+	/// <param name="pc_strName">日志名称</param>
+	/// <param name="p_cszExtension">日志文件的扩展名</param>
+	/// <returns>共享写入状态</returns>
+	std::shared_ptr<SharedLogFile> Acquire(const String& pc_strDirectory, const String& pc_strName, const TCHAR* p_cszExtension);
+
+	/// <summary>
+	/// 当前仍被 Logger 使用的日志文件个数
+	/// </summary>
+	size_t GetFileCount();
+
+	/// <summary>
+	/// 读取级别配置文件并应用到所有存活的 Logger，之后创建的 Logger 也会使用其中的级别。
+	/// <para>每行为"名称 = 级别"，级别为 TRACE、DEBUG、INFO、WARN、ERROR 或 NONE，不区分大小写；名称为"*"时作用于未单独配置的 Logger，以'#'开头的行为注释。
+	/// 从配置中删除的条目不会恢复对应 Logger 原先的级别</para>
+	/// </summary>
+	/// <param name="pc_strPath">配置文件路径</param>
+	/// <returns>文件是否读取成功</returns>
+	bool LoadConfig(const String& pc_strPath);
+
+	/// <summary>
+	/// 读取级别配置文件，并在后台线程中监视其所在目录，文件被修改、创建或重命名后自动重新读取。已在监视其他文件时改为监视给定文件
+	/// </summary>
+	/// <param name="pc_strPath">配置文件路径</param>
+	/// <returns>是否成功开始监视</returns>
+	bool WatchConfig(const String& pc_strPath);
+
+	/// <summary>
+	/// 停止监视配置文件，已应用的级别保持不变
+	/// </summary>
+	void StopWatching();
+
+	/// <summary>
+	/// 获取所有已执行过的 TraceM/DebugM 调用点
+	/// </summary>
+	/// <returns>按编号排列的调用点快照</returns>
+	std::vector<LogSiteInfo> GetSites();
+
+	/// <summary>
+	/// 单独打开或关闭一个调用点，ENABLED 时即使 Logger 的级别更高也会记录
+	/// </summary>
+	/// <param name="p_nId">调用点编号</param>
+	/// <param name="p_mode">调用点的开关</param>
+	/// <returns>调用点是否存在</returns>
+	bool SetSiteMode(uint32_t p_nId, LogSiteMode p_mode);
+};
+
+_UTILS_END
+
+#pragma warning(pop)
\ No newline at end of file
@@ -0,0 +1,296 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DateTimeUtils.h"
+#include "LockFreeQueue.hpp"
+#include "LogFileWriter.h"
+#include "LogLevel.h"
+#include "StringUtils.h"
+
+#pragma warning(push)
+#pragma warning(disable : 4251)
+
+_UTILS_BEGIN
+
+/// <summary>
+/// 交给各输出目标的一条已格式化记录，所有视图仅在 Write 调用期间有效
+/// </summary>
+struct LogSinkRecord {
+	DateTime dtTime {};
+	LogLevel level = LogLevel::NONE;
+	const TCHAR* pcszFuncName = nullptr;
+
+	/// <summary>
+	/// 去除首尾空白后的消息
+	/// </summary>
+	StringView svMsg;
+
+	/// <summary>
+	/// 按 Logger::FormatLine 格式化的整行，以'\n'结尾，且 data() 以'\0'结尾
+	/// </summary>
+	StringView svLine;
+
+	/// <summary>
+	/// 整行按日志文件的编码转换后的字节
+	/// </summary>
+	std::string_view svBytes;
+};
+
+/// <summary>
+/// 日志的输出目标。同一记录只格式化一次，再依次交给 Logger 上的每个输出目标，各目标有独立的级别过滤。
+/// <para>Write 可能被多个线程同时调用，实现需自行保证线程安全</para>
+/// </summary>
+class UTILS_API LogSink {
+private:
+	std::atomic<LogLevel> m_level_;
+
+public:
+	/// <summary>
+	/// 创建输出目标
+	/// </summary>
+	/// <param name="p_level">输出目标接受的最低级别</param>
+	explicit LogSink(LogLevel p_level = LogLevel::TRACE);
+	LogSink(const LogSink&)            = delete;
+	LogSink& operator=(const LogSink&) = delete;
+	virtual ~LogSink()                 = default;
+
+	/// <summary>
+	/// 输出目标接受的最低级别
+	/// </summary>
+	DECLARE_PROPERTY(LogLevel, Level);
+
+	inline LogLevel GetLevel() const noexcept {
+		return m_level_.load(std::memory_order_relaxed);
+	}
+
+	inline void SetLevel(LogLevel p_level) noexcept {
+		m_level_.store(p_level, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// 是否接受给定级别的记录
+	/// </summary>
+	inline bool Accepts(LogLevel p_level) const noexcept {
+		return p_level >= this->GetLevel();
+	}
+
+	/// <summary>
+	/// 输出一条记录
+	/// </summary>
+	/// <param name="pc_record">已格式化的记录</param>
+	virtual void Write(const LogSinkRecord& pc_record) = 0;
+
+	/// <summary>
+	/// 将缓冲的输出交给操作系统
+	/// </summary>
+	virtual void Flush() {
+	}
+};
+
+/// <summary>
+/// 以追加方式写入单个文件，不做切换与保留
+/// </summary>
+class UTILS_API FileLogSink : public LogSink {
+private:
+	std::mutex m_mtxWrite_;
+	BufferedLogFileWriter m_writer_;
+
+public:
+	/// <summary>
+	/// 打开给定文件作为输出目标，所在目录不存在时自动创建
+	/// </summary>
+	/// <param name="pc_strPath">文件路径</param>
+	/// <param name="p_level">输出目标接受的最低级别</param>
+	/// <exception cref="InvalidArgumentException">文件无法打开时抛出</exception>
+	FileLogSink(const String& pc_strPath, LogLevel p_level = LogLevel::TRACE);
+
+	void Write(const LogSinkRecord& pc_record) override;
+	void Flush() override;
+};
+
+/// <summary>
+/// 写入标准错误输出
+/// </summary>
+class UTILS_API StdErrLogSink : public LogSink {
+public:
+	using LogSink::LogSink;
+
+	void Write(const LogSinkRecord& pc_record) override;
+	void Flush() override;
+};
+
+/// <summary>
+/// 通过 OutputDebugString 写入调试器，调试版本的 Logger 默认带有此输出目标
+/// </summary>
+class UTILS_API DebugOutputLogSink : public LogSink {
+public:
+	using LogSink::LogSink;
+
+	void Write(const LogSinkRecord& pc_record) override;
+};
+
+/// <summary>
+/// 在内存中保留最近的若干行
+/// </summary>
+class UTILS_API MemoryLogSink : public LogSink {
+private:
+	mutable std::mutex m_mtxLines_;
+	std::vector<String> m_vLines_;
+	size_t m_nNext_  = 0;
+	size_t m_nCount_ = 0;
+
+public:
+	/// <summary>
+	/// 创建内存输出目标
+	/// </summary>
+	/// <param name="p_nCapacity">保留的行数</param>
+	/// <param name="p_level">输出目标接受的最低级别</param>
+	MemoryLogSink(size_t p_nCapacity, LogLevel p_level = LogLevel::TRACE);
+
+	void Write(const LogSinkRecord& pc_record) override;
+
+	/// <summary>
+	/// 按由旧到新的顺序获取保留的行
+	/// </summary>
+	std::vector<String> GetLines() const;
+
+	/// <summary>
+	/// 清空保留的行
+	/// </summary>
+	void Clear();
+};
+
+/// <summary>
+/// 将记录交给用户提供的回调
+/// </summary>
+class UTILS_API CallbackLogSink : public LogSink {
+public:
+	using Callback = std::function<void(const LogSinkRecord&)>;
+
+private:
+	Callback m_fnCallback_;
+
+public:
+	/// <summary>
+	/// 创建回调输出目标
+	/// </summary>
+	/// <param name="p_fnCallback">回调，可能被多个线程同时调用</param>
+	/// <param name="p_level">输出目标接受的最低级别</param>
+	CallbackLogSink(Callback p_fnCallback, LogLevel p_level = LogLevel::TRACE);
+
+	void Write(const LogSinkRecord& pc_record) override;
+};
+
+/// <summary>
+/// 通过本机 TCP 连接把记录批量发送给收集进程，代替先写本地文件、再由代理读取文件。
+/// <para>Write 只把整行字节放入有界队列，从不等待网络：队列已满时丢弃该记录并计数。后台线程将队列中的记录打包成帧发送，
+/// 连接失败或断开后按指数退避重连，未发出的帧在重连后重发，期间新记录继续进入队列</para>
+/// <para>帧格式：uint32 小端序负载长度，之后为若干条完整的日志行，编码与日志文件一致。可用 LogCollector 作为收集进程</para>
+/// </summary>
+class UTILS_API SocketLogSink : public LogSink {
+public:
+	/// <summary>
+	/// 单帧负载的上限，收集进程据此拒绝损坏的帧。超过上限的单条记录不发送，计入丢弃数
+	/// </summary>
+	static constexpr size_t MAX_FRAME_SIZE = 256 * 1024;
+
+	/// <summary>
+	/// 队列中没有足够记录时，发送线程最多等待这么久再发出不满的帧
+	/// </summary>
+	static constexpr std::chrono::milliseconds FLUSH_INTERVAL { 50 };
+
+	/// <summary>
+	/// 重连间隔的初始值与上限
+	/// </summary>
+	static constexpr std::chrono::milliseconds MIN_BACKOFF { 100 };
+	static constexpr std::chrono::milliseconds MAX_BACKOFF { 10000 };
+
+private:
+	/// <summary>
+	/// 每放入这么多条记录唤醒一次发送线程，其余时候由 FLUSH_INTERVAL 驱动，避免每条记录都进行一次系统调用
+	/// </summary>
+	static constexpr size_t WAKE_BATCH_SIZE = 256;
+
+	String m_strHost_;
+	uint16_t m_nPort_;
+	LockFreeQueue<std::string> m_queue_;
+
+	std::thread m_thSender_;
+	std::mutex m_mtxSender_;
+	std::condition_variable m_cvSender_;
+	std::condition_variable m_cvSent_;
+	std::atomic<bool> m_bStopping_ { false };
+
+	/// <summary>
+	/// 已发出的记录数，在 m_mtxSender_ 下增加，供 Flush 等待
+	/// </summary>
+	std::atomic<size_t> m_nSent_ { 0 };
+	std::atomic<size_t> m_nDropped_ { 0 };
+	std::atomic<bool> m_bConnected_ { false };
+
+	void SendLoop_();
+	uintptr_t Connect_() const;
+
+public:
+	/// <summary>
+	/// 创建输出目标并在后台连接收集进程，连接失败不影响构造，稍后会自动重试
+	/// </summary>
+	/// <param name="p_nPort">收集进程监听的端口</param>
+	/// <param name="p_level">输出目标接受的最低级别</param>
+	/// <param name="p_nCapacity">队列容量，向上取整为2的幂</param>
+	/// <param name="pc_strHost">收集进程所在的主机，默认为本机</param>
+	/// <exception cref="InvalidArgumentException">Winsock 初始化失败时抛出</exception>
+	SocketLogSink(uint16_t p_nPort, LogLevel p_level = LogLevel::TRACE, size_t p_nCapacity = 8192, const String& pc_strHost = TEXT("127.0.0.1"));
+
+	/// <summary>
+	/// 停止发送线程，已在队列中的记录仅在连接可用时发出
+	/// </summary>
+	~SocketLogSink() override;
+
+	void Write(const LogSinkRecord& pc_record) override;
+
+	/// <summary>
+	/// 等待此前放入队列的记录发出，连接不可用时最多等待1秒
+	/// </summary>
+	void Flush() override;
+
+	/// <summary>
+	/// 等待此前放入队列的记录发出
+	/// </summary>
+	/// <param name="p_timeout">最长等待时间</param>
+	/// <returns>是否在超时前全部发出</returns>
+	bool Flush(std::chrono::milliseconds p_timeout);
+
+	/// <summary>
+	/// 已发出的记录数
+	/// </summary>
+	inline size_t GetSentCount() const noexcept {
+		return m_nSent_.load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// 因队列已满或超过 MAX_FRAME_SIZE 而丢弃的记录数
+	/// </summary>
+	inline size_t GetDroppedCount() const noexcept {
+		return m_nDropped_.load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// 当前是否已连接到收集进程
+	/// </summary>
+	inline bool IsConnected() const noexcept {
+		return m_bConnected_.load(std::memory_order_relaxed);
+	}
+};
+
+_UTILS_END
+
+#pragma warning(pop)
\ No newline at end of file
@@ -1,6 +1,22 @@
 #pragma once
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <thread>
+#include <variant>
 
+#include "DateTimeUtils.h"
+#include "LockFreeQueue.hpp"
+#include "LogFlightRecorder.h"
+#include "LogFileWriter.h"
+#include "LogManager.h"
+#include "LogSink.h"
 #include "StringUtils.h"
 
 #pragma warning(push)
@@ -8,40 +24,666 @@
 
 _UTILS_BEGIN
 
-enum class UTILS_API LogLevel {
-	NONE,
-	TRACE,
-	DEBUG,
-	INFO,
-	WARN,
-	ERR,
+// 与 LogLevel 的取值一致，供预处理器比较
+#define UTILS_LOG_LEVEL_TRACE 1
+#define UTILS_LOG_LEVEL_DEBUG 2
+#define UTILS_LOG_LEVEL_INFO 3
+#define UTILS_LOG_LEVEL_WARN 4
+#define UTILS_LOG_LEVEL_ERR 5
+
+// 编译期的最低日志级别，默认不剔除任何级别。可在包含本文件前自行定义，低于此级别的 xxxM/xxxF/xxxB/xxxR/xxxS/xxxJ 宏不会生成任何代码；
+// 只作用于宏，Logger 的成员函数不受影响，因此各模块可以使用不同的值，运行时调高级别或启用调用点仍对未剔除的调用有效
+#ifndef UTILS_LOG_MIN_LEVEL
+#define UTILS_LOG_MIN_LEVEL UTILS_LOG_LEVEL_TRACE
+#endif // !UTILS_LOG_MIN_LEVEL
+
+/// <summary>
+/// 异步日志队列已满时的处理策略
+/// </summary>
+enum class UTILS_API LogOverflowPolicy {
+	/// <summary>
+	/// 阻塞调用线程，直到队列出现空位
+	/// </summary>
+	BLOCK,
+
+	/// <summary>
+	/// 丢弃当前记录
+	/// </summary>
+	DROP_NEWEST,
+
+	/// <summary>
+	/// 丢弃队列中最早的记录；队头的记录多次取不出时（其他线程正在取出或写入同一格）改为丢弃本条
+	/// </summary>
+	DROP_OLDEST,
 };
 
-#ifdef _DEBUG
-#define DEFAULT_LOG_LEVEL LogLevel::DEBUG
-#else
-#define DEFAULT_LOG_LEVEL LogLevel::INFO
-#endif // DEBUG
+/// <summary>
+/// 二进制日志文件的格式定义，供 Logger 与解码工具共用，所有数值均为小端序
+/// </summary>
+struct LogBinaryFormat {
+	/// <summary>
+	/// 文件头：MAGIC、uint32 字符宽度、int64 每秒的时间刻度数
+	/// </summary>
+	static constexpr char MAGIC[4] = { 'U', 'L', 'B', '1' };
+
+	/// <summary>
+	/// 二进制日志文件的扩展名
+	/// </summary>
+	static constexpr const TCHAR* FILE_EXTENSION = TEXT("blog");
+
+	enum class Entry : uint8_t {
+		/// <summary>
+		/// 调用点定义：uint32 编号、uint16 函数名长度与字符、uint16 格式串长度与字符
+		/// </summary>
+		SITE = 1,
+
+		/// <summary>
+		/// 调用点记录：uint32 调用点编号、int64 时间刻度、uint8 级别、uint32 参数字节数与参数
+		/// </summary>
+		RECORD,
+
+		/// <summary>
+		/// 已格式化的消息：int64 时间刻度、uint8 级别、uint16 函数名长度与字符、uint32 消息长度与字符
+		/// </summary>
+		MESSAGE,
+	};
+
+	/// <summary>
+	/// 参数的类型标记，其后紧跟参数的原始字节，字符串为 uint32 长度加字符
+	/// </summary>
+	enum class Arg : uint8_t {
+		BOOL   = 'b',
+		CHAR   = 'c',
+		INT    = 'i',
+		UINT   = 'u',
+		DOUBLE = 'd',
+		STRING = 's',
+	};
+
+	/// <summary>
+	/// 从文件头开始逐条解析，返回最后一条完整条目的结束位置，用于截掉未正常关闭时残留的预分配空白
+	/// </summary>
+	/// <param name="p_pData">文件的全部内容</param>
+	/// <param name="p_nSize">文件的字节数</param>
+	/// <returns>有效长度，尚未写入文件头时为 0，不是二进制日志时为文件的字节数</returns>
+	static size_t FindValidLength(const char* p_pData, size_t p_nSize) noexcept {
+		constexpr size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint32_t) + sizeof(int64_t);
+		if (p_nSize < HEADER_SIZE || std::memcmp(p_pData, MAGIC, sizeof(MAGIC)) != 0) {
+			return p_nSize == 0 || p_pData[0] == '\0' ? 0 : p_nSize;
+		}
+
+		uint32_t nCharSize;
+		std::memcpy(&nCharSize, p_pData + sizeof(MAGIC), sizeof(nCharSize));
+
+		size_t nPos = HEADER_SIZE;
+		// 读取 p_nBytes 字节的长度字段，并跳过长度字段与其后 p_nUnit 倍长度的内容
+		const auto skipSized = [&](size_t& p_nCursor, size_t p_nBytes, size_t p_nUnit) noexcept {
+			if (p_nSize - p_nCursor < p_nBytes) {
+				return false;
+			}
+			uint32_t nLength = 0;
+			std::memcpy(&nLength, p_pData + p_nCursor, p_nBytes);
+			p_nCursor += p_nBytes;
+			if ((p_nSize - p_nCursor) / p_nUnit < nLength) {
+				return false;
+			}
+			p_nCursor += nLength * p_nUnit;
+			return true;
+		};
+		const auto skip = [&](size_t& p_nCursor, size_t p_nBytes) noexcept {
+			if (p_nSize - p_nCursor < p_nBytes) {
+				return false;
+			}
+			p_nCursor += p_nBytes;
+			return true;
+		};
+		// 时间刻度与级别不会为 0，借此识别只写入了开头几个字节、其余仍为空白的条目
+		const auto skipNonZero = [&](size_t& p_nCursor, size_t p_nBytes) noexcept {
+			const size_t nBegin = p_nCursor;
+			return skip(p_nCursor, p_nBytes) && std::any_of(p_pData + nBegin, p_pData + p_nCursor, [](char p_ch) { return p_ch != '\0'; });
+		};
+
+		while (nPos < p_nSize) {
+			size_t nCursor = nPos + 1;
+			bool bComplete = false;
+			switch (static_cast<Entry>(p_pData[nPos])) {
+				case Entry::SITE: {
+					// 函数名不会为空
+					const size_t nFuncName = nCursor + sizeof(uint32_t);
+					bComplete = skip(nCursor, sizeof(uint32_t)) && skipSized(nCursor, sizeof(uint16_t), nCharSize)
+					         && nCursor > nFuncName + sizeof(uint16_t) && skipSized(nCursor, sizeof(uint16_t), nCharSize);
+					break;
+				}
+				case Entry::RECORD:
+					bComplete = skip(nCursor, sizeof(uint32_t)) && skipNonZero(nCursor, sizeof(int64_t)) && skipNonZero(nCursor, sizeof(uint8_t))
+					         && skipSized(nCursor, sizeof(uint32_t), 1);
+					break;
+				case Entry::MESSAGE:
+					bComplete = skipNonZero(nCursor, sizeof(int64_t)) && skipNonZero(nCursor, sizeof(uint8_t))
+					         && skipSized(nCursor, sizeof(uint16_t), nCharSize) && skipSized(nCursor, sizeof(uint32_t), nCharSize);
+					break;
+				default:
+					break;
+			}
+			if (!bComplete) {
+				break;
+			}
+			nPos = nCursor;
+		}
+		return nPos;
+	}
+};
+
+/// <summary>
+/// 文本日志文件的时间索引，与日志文件同名并追加 .idx 扩展名，供 Logger 与查询工具共用，所有数值均为小端序
+/// </summary>
+struct LogIndexFormat {
+	/// <summary>
+	/// 文件头：MAGIC、int64 每秒的时间刻度数
+	/// </summary>
+	static constexpr char MAGIC[4] = { 'U', 'L', 'I', '1' };
+
+	/// <summary>
+	/// 索引文件追加在日志文件名之后的扩展名
+	/// </summary>
+	static constexpr const TCHAR* FILE_EXTENSION = TEXT(".idx");
+
+	/// <summary>
+	/// 文件头之后的索引项，按写入顺序排列：一次写入的第一条记录的时间刻度及其在日志文件中的字节偏移
+	/// </summary>
+	struct Entry {
+		int64_t nTicks;
+		uint64_t nOffset;
+	};
+};
+
+/// <summary>
+/// 日志调用点，由 xxxB 宏在每个调用点创建一次，并获得进程内唯一的编号
+/// </summary>
+class UTILS_API LogCallSite {
+private:
+	uint32_t m_nId_;
+	LPCTSTR m_cszFuncName_;
+	LPCTSTR m_cszFormat_;
+
+public:
+	/// <summary>
+	/// 创建调用点
+	/// </summary>
+	/// <param name="p_cszFuncName">调用点所在的函数名，需具有静态生存期</param>
+	/// <param name="p_cszFormat">调用点的格式字符串，需具有静态生存期</param>
+	LogCallSite(LPCTSTR p_cszFuncName, LPCTSTR p_cszFormat);
+	LogCallSite(const LogCallSite&)            = delete;
+	LogCallSite& operator=(const LogCallSite&) = delete;
+
+	DECLARE_READONLY_PROPERTY_WITH_BODY(uint32_t, Id, m_nId_);
+	DECLARE_READONLY_PROPERTY_WITH_BODY(LPCTSTR, FuncName, m_cszFuncName_);
+	DECLARE_READONLY_PROPERTY_WITH_BODY(LPCTSTR, Format, m_cszFormat_);
+};
+
+/// <summary>
+/// 调用点的限流器，由 xxxR/xxxS 宏在每个调用点创建一次并登记到 LogManager。
+/// <para>先按 1/N 采样，再按令牌桶限制速率，两者都不加锁，被抑制的调用只需几次原子操作；</para>
+/// <para>被抑制的调用数在下一次放行时汇总，若一直未再放行，则在一个限流窗口后、Flush 时或 Logger 析构时汇总</para>
+/// </summary>
+class UTILS_API LogRateLimiter {
+	friend class Logger;
+	friend class LogManager;
+
+private:
+	LPCTSTR m_cszFuncName_;
+
+	/// <summary>
+	/// 令牌桶以 GCRA 形式实现：m_nTat_ 为理论到达时间，每放行一条前进一个发放间隔
+	/// </summary>
+	int64_t m_nInterval_;
+	int64_t m_nTolerance_;
+	std::atomic<int64_t> m_nTat_ { 0 };
+
+	size_t m_nSampleEvery_;
+	std::atomic<size_t> m_nCalls_ { 0 };
+	std::atomic<size_t> m_nSuppressed_ { 0 };
+
+	/// <summary>
+	/// 最近一次抑制调用的 Logger 与级别，m_bPending_ 表示有尚未汇总的抑制，由 LogManager 在汇总时清除
+	/// </summary>
+	std::atomic<const Logger*> m_pLogger_ { nullptr };
+	std::atomic<LogLevel> m_level_ { LogLevel::NONE };
+	std::atomic<bool> m_bPending_ { false };
+
+	bool MarkPending_(const Logger* p_pLogger, LogLevel p_level) noexcept;
+	std::chrono::steady_clock::duration GetWindow_() const noexcept;
+
+public:
+	/// <summary>
+	/// 创建限流器
+	/// </summary>
+	/// <param name="p_cszFuncName">调用点所在的函数名，需具有静态生存期</param>
+	/// <param name="p_dRatePerSecond">每秒允许的记录数，不大于0表示不限速</param>
+	/// <param name="p_nBurst">允许的突发记录数</param>
+	/// <param name="p_nSampleEvery">每N次调用只记录1次，不大于1表示不采样</param>
+	LogRateLimiter(LPCTSTR p_cszFuncName, double p_dRatePerSecond, size_t p_nBurst = 1, size_t p_nSampleEvery = 1);
+	LogRateLimiter(const LogRateLimiter&)            = delete;
+	LogRateLimiter& operator=(const LogRateLimiter&) = delete;
+	~LogRateLimiter();
+
+	DECLARE_READONLY_PROPERTY_WITH_BODY(LPCTSTR, FuncName, m_cszFuncName_);
+
+	/// <summary>
+	/// 判断本次调用是否放行
+	/// </summary>
+	/// <param name="p_nSuppressed">放行时返回自上次放行以来被抑制的调用数</param>
+	/// <returns>是否放行</returns>
+	bool TryAcquire(size_t& p_nSuppressed) noexcept;
+};
+
+/// <summary>
+/// 调用点的启用状态，由 TraceM/DebugM 宏在每个调用点创建一次并登记到 LogManager。
+/// <para>状态缓存了所绑定的 Logger 对该调用点级别的判断，级别变化或通过 LogManager 切换调用点时由 LogManager 更新，
+/// 被禁用的调用只需一次 relaxed 读取与一次比较，且不会求值消息</para>
+/// </summary>
+class UTILS_API LogSiteGate {
+	friend class LogManager;
+
+private:
+	/// <summary>
+	/// 所绑定的 Logger 的地址，最低位表示是否启用，为0表示尚未绑定。只在 LogManager 的调用点锁内写入
+	/// </summary>
+	std::atomic<uintptr_t> m_nState_ { 0 };
+
+	/// <summary>
+	/// 通过 LogManager 设置的开关，由 LogManager 的调用点锁保护
+	/// </summary>
+	LogSiteMode m_mode_ = LogSiteMode::DEFAULT;
+
+	uint32_t m_nId_ = 0;
+	LogLevel m_level_;
+	LPCTSTR m_cszFuncName_;
+	LPCTSTR m_cszFile_;
+	uint32_t m_nLine_;
+
+	bool Bind_(const Logger* p_pLogger) noexcept;
+
+public:
+	/// <summary>
+	/// 创建调用点并登记到 LogManager
+	/// </summary>
+	/// <param name="p_level">调用点的级别</param>
+	/// <param name="p_cszFuncName">调用点所在的函数名，需具有静态生存期</param>
+	/// <param name="p_cszFile">调用点所在的源文件，需具有静态生存期</param>
+	/// <param name="p_nLine">调用点所在的行</param>
+	LogSiteGate(LogLevel p_level, LPCTSTR p_cszFuncName, LPCTSTR p_cszFile, uint32_t p_nLine);
+	LogSiteGate(const LogSiteGate&)            = delete;
+	LogSiteGate& operator=(const LogSiteGate&) = delete;
+	~LogSiteGate();
+
+	DECLARE_READONLY_PROPERTY_WITH_BODY(uint32_t, Id, m_nId_);
+	DECLARE_READONLY_PROPERTY_WITH_BODY(LogLevel, Level, m_level_);
+	DECLARE_READONLY_PROPERTY_WITH_BODY(LPCTSTR, FuncName, m_cszFuncName_);
+	DECLARE_READONLY_PROPERTY_WITH_BODY(LPCTSTR, File, m_cszFile_);
+	DECLARE_READONLY_PROPERTY_WITH_BODY(uint32_t, Line, m_nLine_);
+
+	/// <summary>
+	/// 判断调用点对给定 Logger 是否启用。与上次绑定的 Logger 不同时重新绑定，同一调用点交替用于多个 Logger 时每次切换都需加锁
+	/// </summary>
+	inline bool IsEnabled(const Logger* p_pLogger) noexcept {
+		const uintptr_t nState = m_nState_.load(std::memory_order_relaxed);
+		if ((nState & ~uintptr_t(1)) == reinterpret_cast<uintptr_t>(p_pLogger)) [[likely]] {
+			return (nState & 1) != 0;
+		}
+		return this->Bind_(p_pLogger);
+	}
+};
+
+/// <summary>
+/// 结构化日志的一个字段。键与字符串值均不复制，仅在记录调用期间有效
+/// </summary>
+struct LogField {
+	using Value = std::variant<bool, int64_t, uint64_t, double, StringView, DateTime>;
+
+	StringView svKey;
+	Value value;
+
+	inline LogField(StringView p_svKey, bool p_bValue) noexcept
+	    : svKey(p_svKey)
+	    , value(p_bValue) {
+	}
+
+	template <std::signed_integral _Type>
+	inline LogField(StringView p_svKey, _Type p_nValue) noexcept
+	    : svKey(p_svKey)
+	    , value(static_cast<int64_t>(p_nValue)) {
+	}
+
+	template <std::unsigned_integral _Type>
+	inline LogField(StringView p_svKey, _Type p_nValue) noexcept
+	    : svKey(p_svKey)
+	    , value(static_cast<uint64_t>(p_nValue)) {
+	}
+
+	template <std::floating_point _Type>
+	inline LogField(StringView p_svKey, _Type p_dValue) noexcept
+	    : svKey(p_svKey)
+	    , value(static_cast<double>(p_dValue)) {
+	}
+
+	inline LogField(StringView p_svKey, StringView p_svValue) noexcept
+	    : svKey(p_svKey)
+	    , value(p_svValue) {
+	}
+
+	inline LogField(StringView p_svKey, const TCHAR* p_cszValue) noexcept
+	    : svKey(p_svKey)
+	    , value(StringView(p_cszValue)) {
+	}
+
+	inline LogField(StringView p_svKey, const String& pc_strValue) noexcept
+	    : svKey(p_svKey)
+	    , value(StringView(pc_strValue)) {
+	}
+
+	inline LogField(StringView p_svKey, const DateTime& pc_dtValue) noexcept
+	    : svKey(p_svKey)
+	    , value(pc_dtValue) {
+	}
+};
+
+/// <summary>
+/// 一条待写入的日志记录
+/// </summary>
+struct LogRecord {
+	DateTime dtTime {};
+	LogLevel level = LogLevel::NONE;
+	const TCHAR* pcszFuncName = nullptr;
+	String strMsg;
+
+	/// <summary>
+	/// 二进制记录的调用点及其已编码的参数，文本记录时为空
+	/// </summary>
+	const LogCallSite* pSite = nullptr;
+	std::string strPayload;
+
+	/// <summary>
+	/// strPayload 是否为已在调用线程中生成的最终字节，带结构化字段的记录在异步模式下以此形式入队
+	/// </summary>
+	bool bRaw = false;
+};
 
 class UTILS_API Logger {
+	friend class LogManager;
+
 private:
-	mutable bool m_bFirstLog_ = true;
+	/// <summary>
+	/// 后台写线程每批次最多处理的记录数
+	/// </summary>
+	static constexpr size_t WRITER_BATCH_SIZE = 256;
+
+	/// <summary>
+	/// DROP_OLDEST 策略下取出队头失败的最多次数，超过后丢弃本条记录
+	/// </summary>
+	static constexpr size_t MAX_DROP_OLDEST_RETRIES = 16;
 
 	String m_strName_;
-	LogLevel m_logLevel_;
+
+	/// <summary>
+	/// 当前级别，可被配置文件监视线程随时修改，检查级别只需一次 relaxed 读取
+	/// </summary>
+	std::atomic<LogLevel> m_logLevel_;
 	String m_strLogFilePath_;
 
+	/// <summary>
+	/// 与写入同一文件的其他 Logger 共享的写入状态，首次写入时由 LogManager 获取
+	/// </summary>
+	mutable std::shared_ptr<SharedLogFile> m_pShared_;
+	mutable std::once_flag m_onceShared_;
+
+	/// <summary>
+	/// 是否通过内存映射写入日志文件
+	/// </summary>
+	bool m_bMappedFile_ = false;
+
+	/// <summary>
+	/// 是否以二进制格式记录
+	/// </summary>
+	bool m_bBinaryMode_ = false;
+
+	/// <summary>
+	/// 是否以每行一个 JSON 对象的格式记录
+	/// </summary>
+	bool m_bJsonLines_ = false;
+
+	/// <summary>
+	/// 落盘策略及其参数
+	/// </summary>
+	LogDurability m_durability_ = LogDurability::NONE;
+	size_t m_nSyncEveryN_      = 64;
+	size_t m_nSyncIntervalMs_  = 1000;
+
+	size_t m_nMaxFileSize_   = 0;
+	size_t m_nMaxFileCount_  = 0;
+	size_t m_nMaxTotalSize_  = 0;
+	bool m_bCompressRotated_ = false;
+	size_t m_nIndexInterval_ = 0;
+
+	/// <summary>
+	/// 后台维护线程，负责压缩已切换的日志文件并执行保留策略
+	/// </summary>
+	mutable std::thread m_thMaintainer_;
+	mutable std::mutex m_mtxMaintain_;
+	mutable std::condition_variable m_cvMaintain_;
+	mutable std::deque<String> m_dqRotatedFiles_;
+	mutable bool m_bStopMaintain_ = false;
+
+	/// <summary>
+	/// 汇总限流器中被抑制调用数的时间，由维护线程执行，没有待汇总的抑制时为最大值
+	/// </summary>
+	mutable std::chrono::steady_clock::time_point m_tpSuppressedDue_ = std::chrono::steady_clock::time_point::max();
+
+	/// <summary>
+	/// 文件之外的输出目标，m_bHasSinks_ 使没有输出目标时无需加锁
+	/// </summary>
+	std::vector<std::shared_ptr<LogSink>> m_vSinks_;
+	mutable std::shared_mutex m_mtxSinks_;
+	std::atomic<bool> m_bHasSinks_ { false };
+
+	/// <summary>
+	/// 飞行记录器，为空时表示未启用
+	/// </summary>
+	std::unique_ptr<LogFlightRecorder> m_pRecorder_;
+
+	/// <summary>
+	/// 异步模式下的记录队列，为空时表示同步模式
+	/// </summary>
+	std::unique_ptr<LockFreeQueue<LogRecord>> m_pQueue_;
+	LogOverflowPolicy m_overflowPolicy_ = LogOverflowPolicy::BLOCK;
+	std::thread m_thWriter_;
+	std::atomic<bool> m_bStopping_ { false };
+	mutable std::atomic<bool> m_bWriterIdle_ { false };
+	mutable std::atomic<size_t> m_nProcessed_ { 0 };
+	mutable std::atomic<size_t> m_nDropped_ { 0 };
+
+#ifdef _UNICODE
+	using FormatContext_ = std::wformat_context;
+#else
+	using FormatContext_ = std::format_context;
+#endif // _UNICODE
+
+	template <typename... _Args>
+	using FormatString_ = std::basic_format_string<TCHAR, std::type_identity_t<_Args>...>;
+
 private:
-	void Log_(const TCHAR* p_cszFuncName, const String& pc_strType, const String& pc_strMsg) const;
+	void Log_(const TCHAR* p_cszFuncName, LogLevel p_level, StringView p_svMsg, std::span<const LogField> p_fields = {}) const;
+	void LogFormat_(const TCHAR* p_cszFuncName, LogLevel p_level, StringView p_svFmt, std::basic_format_args<FormatContext_> p_args) const;
+	void LogBinary_(LogLevel p_level, const LogCallSite& pc_site, const std::string& pc_strPayload) const;
+	void Enqueue_(LogRecord&& p_record) const;
+	void WakeWriter_() const noexcept;
+	void WaitWritten_() const;
+	void WriterLoop_();
+	void AppendRecord_(std::string& p_strBytes, const LogRecord& pc_record) const;
+	void AppendMessage_(std::string& p_strBytes, const DateTime& pc_dtTime, LogLevel p_level, const TCHAR* p_cszFuncName, StringView p_svMsg,
+	    std::span<const LogField> p_fields = {}) const;
+	void AppendSiteRecord_(
+	    std::string& p_strBytes, const DateTime& pc_dtTime, LogLevel p_level, const LogCallSite& pc_site, const std::string& pc_strPayload) const;
+	bool EnsureFile_(const DateTime& pc_dtTime) const;
+	uint64_t WriteBytes_(const std::string& pc_strBytes, const DateTime& pc_dtTime, size_t p_nRecords, bool p_bError) const;
+	bool IsSyncDue_(size_t p_nRecords, bool p_bError) const;
+	LogDurability GetFileDurability_() const;
+	void SyncFile_() const noexcept;
+	void Commit_(uint64_t p_nTicket) const;
+	void DispatchToSinks_(const LogSinkRecord& pc_record) const;
+	void RecordFormat_(const TCHAR* p_cszFuncName, LogLevel p_level, StringView p_svFmt, std::basic_format_args<FormatContext_> p_args) const;
+	void LogSuppressed_(LogLevel p_level, const TCHAR* p_cszFuncName, size_t p_nSuppressed) const;
+	void ScheduleSuppressed_(std::chrono::steady_clock::duration p_window) const;
+	bool OpenFile_(const DateTime& pc_dtTime, size_t p_nSegment) const;
+	void OpenIndex_(const String& pc_strFilePath) const;
+	String BuildFilePath_(const DateTime& pc_dtTime, size_t p_nSegment) const;
+	size_t FindLastSegment_(const DateTime& pc_dtTime) const;
+	void QueueRotated_(String&& p_strFilePath) const;
+	void MaintainLoop_() const;
+	void ApplyRetention_() const;
+
+	inline SharedLogFile& GetSharedFile_() const {
+		std::call_once(m_onceShared_,
+		    [this]() { m_pShared_ = LogManager::GetInstance().Acquire(m_strLogFilePath_, m_strName_, this->GetFileExtension_()); });
+		return *m_pShared_;
+	}
+
+	inline const TCHAR* GetFileExtension_() const noexcept {
+		return m_bBinaryMode_ ? LogBinaryFormat::FILE_EXTENSION : m_bJsonLines_ ? TEXT("jsonl") : TEXT("log");
+	}
+
+	static StringView TrimMessage_(StringView p_svMsg) noexcept;
+	static std::string& GetPayloadBuffer_() noexcept;
+
+	template <typename _Type>
+	static inline void AppendRaw_(std::string& p_strBytes, const _Type& pc_value) {
+		p_strBytes.append(reinterpret_cast<const char*>(&pc_value), sizeof(_Type));
+	}
+
+	static inline void AppendRawString_(std::string& p_strBytes, StringView p_svValue) {
+		AppendRaw_(p_strBytes, static_cast<uint32_t>(p_svValue.size()));
+		p_strBytes.append(reinterpret_cast<const char*>(p_svValue.data()), p_svValue.size() * sizeof(TCHAR));
+	}
+
+	/// <summary>
+	/// 将一个格式化参数按二进制格式追加到缓冲区
+	/// </summary>
+	template <typename _Type>
+	static void EncodeArg_(std::string& p_strBytes, const _Type& pc_arg) {
+		using _Decayed = std::decay_t<_Type>;
+		using Arg      = LogBinaryFormat::Arg;
+
+		if constexpr (std::is_same_v<_Decayed, bool>) {
+			AppendRaw_(p_strBytes, Arg::BOOL);
+			AppendRaw_(p_strBytes, static_cast<uint8_t>(pc_arg));
+		} else if constexpr (std::is_same_v<_Decayed, TCHAR>) {
+			AppendRaw_(p_strBytes, Arg::CHAR);
+			AppendRaw_(p_strBytes, pc_arg);
+		} else if constexpr (std::is_integral_v<_Decayed> && std::is_signed_v<_Decayed>) {
+			AppendRaw_(p_strBytes, Arg::INT);
+			AppendRaw_(p_strBytes, static_cast<int64_t>(pc_arg));
+		} else if constexpr (std::is_integral_v<_Decayed>) {
+			AppendRaw_(p_strBytes, Arg::UINT);
+			AppendRaw_(p_strBytes, static_cast<uint64_t>(pc_arg));
+		} else if constexpr (std::is_floating_point_v<_Decayed>) {
+			AppendRaw_(p_strBytes, Arg::DOUBLE);
+			AppendRaw_(p_strBytes, static_cast<double>(pc_arg));
+		} else if constexpr (std::is_convertible_v<const _Type&, StringView>) {
+			AppendRaw_(p_strBytes, Arg::STRING);
+			AppendRawString_(p_strBytes, StringView(pc_arg));
+		} else {
+			static_assert(sizeof(_Type) == 0, "binary log arguments only support bool, characters, arithmetic types and strings");
+		}
+	}
+
+	/// <summary>
+	/// 判断给定级别的记录是否需要写入：不低于当前级别时写入，当前级别为 NONE 时不写入任何记录
+	/// </summary>
+	inline bool IsLevelEnabled_(LogLevel p_level) const noexcept {
+		const LogLevel threshold = m_logLevel_.load(std::memory_order_relaxed);
+		return threshold != LogLevel::NONE && p_level >= threshold;
+	}
 
 public:
 	/// <summary>
-	/// 日志级别
+	/// 日志记录器的名称
+	/// </summary>
+	DECLARE_READONLY_PROPERTY_WITH_BODY(String, Name, m_strName_);
+
+	/// <summary>
+	/// 日志级别，低于此级别的记录不写入，NONE 表示不写入任何记录。可在记录日志期间由其他线程修改
+	/// </summary>
+	DECLARE_PROPERTY(_UTILS LogLevel, LogLevel);
+
+	inline _UTILS LogLevel GetLogLevel() const noexcept {
+		return m_logLevel_.load(std::memory_order_relaxed);
+	}
+
+	inline void SetLogLevel(_UTILS LogLevel p_level) noexcept {
+		m_logLevel_.store(p_level, std::memory_order_relaxed);
+		LogManager::GetInstance().RefreshSites_(this);
+	}
+
+	/// <summary>
+	/// 单个日志文件的最大大小，超过后切换到 name-YYYYMMDD.N.log，0表示不限制。
+	/// <para>此项及以下的文件相关设置在首次写入时固定到共用的日志文件上，之后修改或由其他实例设置均不生效</para>
+	/// </summary>
+	DECLARE_PROPERTY_WITH_BODY(size_t, MaxFileSize, m_nMaxFileSize_);
+
+	/// <summary>
+	/// 最多保留的日志文件个数（含当前文件），0表示不限制
+	/// </summary>
+	DECLARE_PROPERTY_WITH_BODY(size_t, MaxFileCount, m_nMaxFileCount_);
+
+	/// <summary>
+	/// 保留的日志文件的最大总字节数，0表示不限制
+	/// </summary>
+	DECLARE_PROPERTY_WITH_BODY(size_t, MaxTotalSize, m_nMaxTotalSize_);
+
+	/// <summary>
+	/// 是否在低优先级后台线程中压缩已切换的日志文件
+	/// </summary>
+	DECLARE_PROPERTY_WITH_BODY(bool, CompressRotated, m_bCompressRotated_);
+
+	/// <summary>
+	/// 文本与 JSON Lines 模式下，每写入多少条记录在 .idx 索引文件中登记一次时间与偏移，可用 LogQuery 按时间范围快速查询，0表示不生成索引。
+	/// 需在开始记录日志前设置
 	/// </summary>
-	DECLARE_PROPERTY_WITH_BODY(LogLevel, LogLevel, m_logLevel_);
+	DECLARE_PROPERTY_WITH_BODY(size_t, IndexInterval, m_nIndexInterval_);
 
 	/// <summary>
-	/// 创建日志记录器实例
+	/// 是否以二进制格式写入 name-YYYYMMDD.blog，需在开始记录日志前设置，可用 LogDecoder 还原为文本
+	/// </summary>
+	DECLARE_PROPERTY_WITH_BODY(bool, BinaryMode, m_bBinaryMode_);
+
+	/// <summary>
+	/// 是否以 JSON Lines 格式写入 name-YYYYMMDD.jsonl，每行为包含 time、level、func、msg 及结构化字段的对象，需在开始记录日志前设置。
+	/// 同时设置 BinaryMode 时以二进制格式为准
+	/// </summary>
+	DECLARE_PROPERTY_WITH_BODY(bool, JsonLines, m_bJsonLines_);
+
+	/// <summary>
+	/// 是否通过内存映射写入日志文件，写入仅为一次内存复制，进程崩溃时已写入的记录仍会保留，需在开始记录日志前设置
+	/// </summary>
+	DECLARE_PROPERTY_WITH_BODY(bool, MappedFile, m_bMappedFile_);
+
+	/// <summary>
+	/// 落盘策略，默认为 LogDurability::NONE
+	/// </summary>
+	DECLARE_PROPERTY_WITH_BODY(LogDurability, Durability, m_durability_);
+
+	/// <summary>
+	/// FLUSH_EVERY_N 策略下两次落盘之间的记录数
+	/// </summary>
+	DECLARE_PROPERTY_WITH_BODY(size_t, SyncEveryN, m_nSyncEveryN_);
+
+	/// <summary>
+	/// FLUSH_EVERY_MS 策略下两次落盘之间的最短间隔（毫秒），空闲时最后的记录在下一次写入或关闭文件时落盘
+	/// </summary>
+	DECLARE_PROPERTY_WITH_BODY(size_t, SyncIntervalMs, m_nSyncIntervalMs_);
+
+	/// <summary>
+	/// 创建日志记录器实例。名称与位置相同的多个实例通过 LogManager 共用同一个日志文件，文件相关的设置以首个写入的实例为准
 	/// </summary>
 	/// <param name="pc_strName">日志记录器的名称</param>
 	/// <param name="pc_strFilePath_">日志文件的位置，默认为应用程序安装目录下的logs目录</param>
@@ -61,8 +703,10 @@ public:
 	/// <param name="p_cszFuncName">当前函数名</param>
 	/// <param name="pc_strMsg">记录的信息</param>
 	inline virtual void Trace(const TCHAR* p_cszFuncName, const String& pc_strMsg) const noexcept {
-		if (m_logLevel_ == LogLevel::TRACE) {
-			this->Log_(p_cszFuncName, TEXT("trace"), pc_strMsg);
+		if (this->IsLevelEnabled_(LogLevel::TRACE)) {
+			this->Log_(p_cszFuncName, LogLevel::TRACE, pc_strMsg);
+		} else if (m_pRecorder_) {
+			m_pRecorder_->Record(DateTimeUtils::Now(), LogLevel::TRACE, p_cszFuncName, pc_strMsg);
 		}
 	}
 
@@ -72,8 +716,10 @@ public:
 	/// <param name="p_cszFuncName">当前函数名</param>
 	/// <param name="pc_strMsg">记录的信息</param>
 	inline virtual void Debug(const TCHAR* p_cszFuncName, const String& pc_strMsg) const noexcept {
-		if (m_logLevel_ <= LogLevel::DEBUG) {
-			this->Log_(p_cszFuncName, TEXT("debug"), pc_strMsg);
+		if (this->IsLevelEnabled_(LogLevel::DEBUG)) {
+			this->Log_(p_cszFuncName, LogLevel::DEBUG, pc_strMsg);
+		} else if (m_pRecorder_) {
+			m_pRecorder_->Record(DateTimeUtils::Now(), LogLevel::DEBUG, p_cszFuncName, pc_strMsg);
 		}
 	}
 
@@ -83,7 +729,11 @@ public:
 	/// <param name="p_cszFuncName">当前函数名</param>
 	/// <param name="pc_strMsg">记录的信息</param>
 	inline virtual void Info(const TCHAR* p_cszFuncName, const String& pc_strMsg) const noexcept {
-		this->Log_(p_cszFuncName, TEXT("info"), pc_strMsg);
+		if (this->IsLevelEnabled_(LogLevel::INFO)) {
+			this->Log_(p_cszFuncName, LogLevel::INFO, pc_strMsg);
+		} else if (m_pRecorder_) {
+			m_pRecorder_->Record(DateTimeUtils::Now(), LogLevel::INFO, p_cszFuncName, pc_strMsg);
+		}
 	}
 
 	/// <summary>
@@ -92,7 +742,11 @@ public:
 	/// <param name="p_cszFuncName">当前函数名</param>
 	/// <param name="pc_strMsg">记录的信息</param>
 	inline virtual void Warn(const TCHAR* p_cszFuncName, const String& pc_strMsg) const noexcept {
-		this->Log_(p_cszFuncName, TEXT("warn"), pc_strMsg);
+		if (this->IsLevelEnabled_(LogLevel::WARN)) {
+			this->Log_(p_cszFuncName, LogLevel::WARN, pc_strMsg);
+		} else if (m_pRecorder_) {
+			m_pRecorder_->Record(DateTimeUtils::Now(), LogLevel::WARN, p_cszFuncName, pc_strMsg);
+		}
 	}
 
 	/// <summary>
@@ -101,17 +755,322 @@ public:
 	/// <param name="p_cszFuncName">当前函数名</param>
 	/// <param name="pc_strMsg">记录的信息</param>
 	inline virtual void Error(const TCHAR* p_cszFuncName, const String& pc_strMsg) const noexcept {
-		this->Log_(p_cszFuncName, TEXT("error"), pc_strMsg);
+		if (this->IsLevelEnabled_(LogLevel::ERR)) {
+			this->Log_(p_cszFuncName, LogLevel::ERR, pc_strMsg);
+		} else if (m_pRecorder_) {
+			m_pRecorder_->Record(DateTimeUtils::Now(), LogLevel::ERR, p_cszFuncName, pc_strMsg);
+		}
+	}
+
+	/// <summary>
+	/// 记录跟踪日志，仅在记录会被写入时才格式化消息
+	/// </summary>
+	/// <param name="p_cszFuncName">当前函数名</param>
+	/// <param name="p_fmt">格式字符串</param>
+	/// <param name="p_args">格式化参数</param>
+	template <typename _Arg, typename... _Args>
+	inline void Trace(const TCHAR* p_cszFuncName, FormatString_<_Arg, _Args...> p_fmt, _Arg&& p_arg, _Args&&... p_args) const noexcept {
+		this->LogFormat_(p_cszFuncName, LogLevel::TRACE, p_fmt.get(), std::make_format_args<FormatContext_>(p_arg, p_args...));
+	}
+
+	/// <summary>
+	/// 记录调试日志，仅在记录会被写入时才格式化消息
+	/// </summary>
+	/// <param name="p_cszFuncName">当前函数名</param>
+	/// <param name="p_fmt">格式字符串</param>
+	/// <param name="p_args">格式化参数</param>
+	template <typename _Arg, typename... _Args>
+	inline void Debug(const TCHAR* p_cszFuncName, FormatString_<_Arg, _Args...> p_fmt, _Arg&& p_arg, _Args&&... p_args) const noexcept {
+		this->LogFormat_(p_cszFuncName, LogLevel::DEBUG, p_fmt.get(), std::make_format_args<FormatContext_>(p_arg, p_args...));
+	}
+
+	/// <summary>
+	/// 记录消息日志，仅在记录会被写入时才格式化消息
+	/// </summary>
+	/// <param name="p_cszFuncName">当前函数名</param>
+	/// <param name="p_fmt">格式字符串</param>
+	/// <param name="p_args">格式化参数</param>
+	template <typename _Arg, typename... _Args>
+	inline void Info(const TCHAR* p_cszFuncName, FormatString_<_Arg, _Args...> p_fmt, _Arg&& p_arg, _Args&&... p_args) const noexcept {
+		this->LogFormat_(p_cszFuncName, LogLevel::INFO, p_fmt.get(), std::make_format_args<FormatContext_>(p_arg, p_args...));
+	}
+
+	/// <summary>
+	/// 记录警告日志，仅在记录会被写入时才格式化消息
+	/// </summary>
+	/// <param name="p_cszFuncName">当前函数名</param>
+	/// <param name="p_fmt">格式字符串</param>
+	/// <param name="p_args">格式化参数</param>
+	template <typename _Arg, typename... _Args>
+	inline void Warn(const TCHAR* p_cszFuncName, FormatString_<_Arg, _Args...> p_fmt, _Arg&& p_arg, _Args&&... p_args) const noexcept {
+		this->LogFormat_(p_cszFuncName, LogLevel::WARN, p_fmt.get(), std::make_format_args<FormatContext_>(p_arg, p_args...));
+	}
+
+	/// <summary>
+	/// 记录错误日志，仅在记录会被写入时才格式化消息
+	/// </summary>
+	/// <param name="p_cszFuncName">当前函数名</param>
+	/// <param name="p_fmt">格式字符串</param>
+	/// <param name="p_args">格式化参数</param>
+	template <typename _Arg, typename... _Args>
+	inline void Error(const TCHAR* p_cszFuncName, FormatString_<_Arg, _Args...> p_fmt, _Arg&& p_arg, _Args&&... p_args) const noexcept {
+		this->LogFormat_(p_cszFuncName, LogLevel::ERR, p_fmt.get(), std::make_format_args<FormatContext_>(p_arg, p_args...));
+	}
+
+	/// <summary>
+	/// 记录调用点日志。二进制模式下仅写入调用点编号与参数的原始字节，格式化推迟到解码时进行；文本模式下与 xxxF 相同
+	/// </summary>
+	/// <param name="p_level">记录级别</param>
+	/// <param name="pc_site">调用点</param>
+	/// <param name="p_fmt">格式字符串，需与调用点的格式字符串相同</param>
+	/// <param name="p_args">格式化参数</param>
+	template <typename... _Args>
+	inline void LogBinary(_UTILS LogLevel p_level, const LogCallSite& pc_site, FormatString_<_Args...> p_fmt, _Args&&... p_args) const noexcept {
+		if (!m_bBinaryMode_ || !this->IsLevelEnabled_(p_level)) {
+			this->LogFormat_(pc_site.GetFuncName(), p_level, p_fmt.get(), std::make_format_args<FormatContext_>(p_args...));
+			return;
+		}
+
+		if (m_pRecorder_) {
+			this->RecordFormat_(pc_site.GetFuncName(), p_level, p_fmt.get(), std::make_format_args<FormatContext_>(p_args...));
+		}
+
+		std::string& strPayload = GetPayloadBuffer_();
+		strPayload.clear();
+		(EncodeArg_(strPayload, p_args), ...);
+		this->LogBinary_(p_level, pc_site, strPayload);
+	}
+
+	/// <summary>
+	/// 记录带结构化字段的日志。JSON Lines 模式下字段按类型直接序列化为 JSON，其他模式下以 key=value 附加在消息之后
+	/// </summary>
+	/// <param name="p_level">记录级别</param>
+	/// <param name="p_cszFuncName">当前函数名</param>
+	/// <param name="p_svMsg">记录的信息</param>
+	/// <param name="p_fields">结构化字段</param>
+	void LogFields(_UTILS LogLevel p_level, const TCHAR* p_cszFuncName, StringView p_svMsg, std::initializer_list<LogField> p_fields) const noexcept;
+
+	/// <summary>
+	/// 通过调用点的启用状态记录日志，调用点被禁用时不求值消息，仅在启用飞行记录器时才生成消息交给飞行记录器
+	/// </summary>
+	/// <param name="p_gate">调用点，通常由 UTILS_LOG_GATE 宏创建</param>
+	/// <param name="p_fnMsg">生成消息的函数</param>
+	template <typename _Fn>
+	inline void LogGated(LogSiteGate& p_gate, _Fn&& p_fnMsg) const noexcept {
+		if (p_gate.IsEnabled(this)) {
+			this->Log_(p_gate.GetFuncName(), p_gate.GetLevel(), p_fnMsg());
+		} else if (m_pRecorder_) {
+			m_pRecorder_->Record(DateTimeUtils::Now(), p_gate.GetLevel(), p_gate.GetFuncName(), TrimMessage_(p_fnMsg()));
+		}
+	}
+
+	/// <summary>
+	/// 记录经过限流的日志，仅在被放行时才生成消息。被抑制的记录数会在下一次放行时以一条汇总记录写入，
+	/// 不再放行时则在一个限流窗口后由维护线程写入
+	/// </summary>
+	/// <param name="p_level">记录级别</param>
+	/// <param name="p_limiter">调用点的限流器</param>
+	/// <param name="p_fnMsg">产生消息的可调用对象</param>
+	template <typename _Fn>
+	inline void LogLimited(_UTILS LogLevel p_level, LogRateLimiter& p_limiter, _Fn&& p_fnMsg) const noexcept {
+		if (!this->IsLevelEnabled_(p_level)) {
+			return;
+		}
+
+		size_t nSuppressed;
+		if (!p_limiter.TryAcquire(nSuppressed)) {
+			if (p_limiter.MarkPending_(this, p_level)) {
+				this->ScheduleSuppressed_(p_limiter.GetWindow_());
+			}
+			return;
+		}
+
+		if (nSuppressed != 0) {
+			this->LogSuppressed_(p_level, p_limiter.GetFuncName(), nSuppressed);
+		}
+		this->Log_(p_limiter.GetFuncName(), p_level, p_fnMsg());
+	}
+
+	/// <summary>
+	/// 将一条记录按文本格式追加到给定字符串，解码工具与文本模式共用此格式
+	/// </summary>
+	/// <param name="p_strOut">输出字符串</param>
+	/// <param name="pc_dtTime">记录时间</param>
+	/// <param name="p_level">记录级别</param>
+	/// <param name="p_cszFuncName">函数名</param>
+	/// <param name="p_svMsg">消息</param>
+	static void FormatLine(String& p_strOut, const DateTime& pc_dtTime, _UTILS LogLevel p_level, const TCHAR* p_cszFuncName, StringView p_svMsg);
+
+	/// <summary>
+	/// 编译期被过滤的记录调用，仅对消息表达式做类型检查而不求值
+	/// </summary>
+	/// <param name="p_fnMsg">产生消息的可调用对象，不会被调用</param>
+	template <typename _Fn>
+	constexpr void Discard(_Fn&& p_fnMsg) const noexcept {
 	}
 
 	const String GetFullFilePath() const;
+
+	/// <summary>
+	/// 启用异步模式，此后的记录仅放入无锁队列，由后台线程批量格式化并写入文件。应在开始记录日志前调用
+	/// </summary>
+	/// <param name="p_nCapacity">队列容量，向上取整为2的幂</param>
+	/// <param name="p_policy">队列已满时的处理策略</param>
+	void EnableAsync(size_t p_nCapacity = 8192, LogOverflowPolicy p_policy = LogOverflowPolicy::BLOCK);
+
+	/// <summary>
+	/// 等待调用前已提交的所有记录写入文件（同步模式下无需等待），并刷新各输出目标
+	/// </summary>
+	void Flush() const;
+
+	/// <summary>
+	/// 添加输出目标。每条文本记录只格式化一次，同时写入日志文件与所有接受其级别的输出目标；二进制模式下调用点记录只写入文件
+	/// </summary>
+	/// <param name="p_pSink">输出目标</param>
+	void AddSink(std::shared_ptr<LogSink> p_pSink);
+
+	/// <summary>
+	/// 移除输出目标
+	/// </summary>
+	/// <param name="pc_pSink">输出目标</param>
+	void RemoveSink(const std::shared_ptr<LogSink>& pc_pSink);
+
+	/// <summary>
+	/// 启用飞行记录器，在内存中保留最近的记录，包括因级别不足而未写入文件的 TRACE/DEBUG 记录。
+	/// 进程异常终止时自动转储到日志目录下的 name.flight.log，应在开始记录日志前调用
+	/// </summary>
+	/// <param name="p_nCapacity">保留的记录数，向上取整为2的幂</param>
+	void EnableFlightRecorder(size_t p_nCapacity = 4096);
+
+	/// <summary>
+	/// 立即转储飞行记录器，未启用时返回 false
+	/// </summary>
+	/// <returns>是否成功</returns>
+	bool DumpFlightRecorder() const noexcept;
+
+	/// <summary>
+	/// 当前是否处于异步模式
+	/// </summary>
+	inline bool IsAsync() const noexcept {
+		return m_pQueue_ != nullptr;
+	}
+
+	/// <summary>
+	/// 因队列已满而被丢弃的记录数
+	/// </summary>
+	DECLARE_READONLY_PROPERTY(size_t, DroppedCount);
+
+	inline size_t GetDroppedCount() const noexcept {
+		return m_nDropped_.load(std::memory_order_relaxed);
+	}
 };
 
-#define TraceM(msg) Trace(TEXT(__FUNCTION__), msg)
-#define DebugM(msg) Debug(TEXT(__FUNCTION__), msg)
+#define UTILS_LOG_SITE(fmt)                                                                                                                    \
+	[](LPCTSTR p_cszFuncName) -> const _UTILS LogCallSite& {                                                                                   \
+		static const _UTILS LogCallSite s_site(p_cszFuncName, TEXT(fmt));                                                                      \
+		return s_site;                                                                                                                         \
+	}(TEXT(__FUNCTION__))
+
+#define UTILS_LOG_GATE(level)                                                                                                                  \
+	[](LPCTSTR p_cszFuncName) -> _UTILS LogSiteGate& {                                                                                         \
+		static _UTILS LogSiteGate s_gate(level, p_cszFuncName, TEXT(__FILE__), __LINE__);                                                      \
+		return s_gate;                                                                                                                         \
+	}(TEXT(__FUNCTION__))
+
+#define UTILS_LOG_LIMITER(rate, burst, sample)                                                                                                 \
+	[](LPCTSTR p_cszFuncName) -> _UTILS LogRateLimiter& {                                                                                      \
+		static _UTILS LogRateLimiter s_limiter(p_cszFuncName, rate, burst, sample);                                                            \
+		return s_limiter;                                                                                                                      \
+	}(TEXT(__FUNCTION__))
+
+// TraceM/DebugM 的每个调用点缓存自己的启用状态，可通过 LogManager::GetSites/SetSiteMode 查看与单独切换
+// xxxR(rate, burst, msg)：每秒最多记录 rate 条，允许 burst 条突发；xxxS(n, msg)：每 n 次调用记录 1 次
+// xxxJ(msg, { key, value }, ...)：记录带结构化字段的日志
+#define UTILS_LOG_RATE(level, rate, burst, msg) LogLimited(level, UTILS_LOG_LIMITER(rate, burst, 1), [&]() { return msg; })
+#define UTILS_LOG_SAMPLE(level, n, msg) LogLimited(level, UTILS_LOG_LIMITER(0, 1, n), [&]() { return msg; })
+
+#define UTILS_LOG_DISCARD(msg) Discard([&]() { return msg; })
+#define UTILS_LOG_DISCARD_F(fmt, ...) Discard([&]() { return FORMAT(fmt, __VA_ARGS__); })
+
+#if UTILS_LOG_MIN_LEVEL <= UTILS_LOG_LEVEL_TRACE
+#define TraceM(msg) LogGated(UTILS_LOG_GATE(_UTILS LogLevel::TRACE), [&]() { return msg; })
+#define TraceF(fmt, ...) Trace(TEXT(__FUNCTION__), TEXT(fmt), __VA_ARGS__)
+#define TraceB(fmt, ...) LogBinary(_UTILS LogLevel::TRACE, UTILS_LOG_SITE(fmt), TEXT(fmt), __VA_ARGS__)
+#define TraceR(rate, burst, msg) UTILS_LOG_RATE(_UTILS LogLevel::TRACE, rate, burst, msg)
+#define TraceS(n, msg) UTILS_LOG_SAMPLE(_UTILS LogLevel::TRACE, n, msg)
+#define TraceJ(msg, ...) LogFields(_UTILS LogLevel::TRACE, TEXT(__FUNCTION__), msg, { __VA_ARGS__ })
+#else
+#define TraceM(msg) UTILS_LOG_DISCARD(msg)
+#define TraceF(fmt, ...) UTILS_LOG_DISCARD_F(fmt, __VA_ARGS__)
+#define TraceB(fmt, ...) UTILS_LOG_DISCARD_F(fmt, __VA_ARGS__)
+#define TraceR(rate, burst, msg) UTILS_LOG_DISCARD(msg)
+#define TraceS(n, msg) UTILS_LOG_DISCARD(msg)
+#define TraceJ(msg, ...) UTILS_LOG_DISCARD(msg)
+#endif
+
+#if UTILS_LOG_MIN_LEVEL <= UTILS_LOG_LEVEL_DEBUG
+#define DebugM(msg) LogGated(UTILS_LOG_GATE(_UTILS LogLevel::DEBUG), [&]() { return msg; })
+#define DebugF(fmt, ...) Debug(TEXT(__FUNCTION__), TEXT(fmt), __VA_ARGS__)
+#define DebugB(fmt, ...) LogBinary(_UTILS LogLevel::DEBUG, UTILS_LOG_SITE(fmt), TEXT(fmt), __VA_ARGS__)
+#define DebugR(rate, burst, msg) UTILS_LOG_RATE(_UTILS LogLevel::DEBUG, rate, burst, msg)
+#define DebugS(n, msg) UTILS_LOG_SAMPLE(_UTILS LogLevel::DEBUG, n, msg)
+#define DebugJ(msg, ...) LogFields(_UTILS LogLevel::DEBUG, TEXT(__FUNCTION__), msg, { __VA_ARGS__ })
+#else
+#define DebugM(msg) UTILS_LOG_DISCARD(msg)
+#define DebugF(fmt, ...) UTILS_LOG_DISCARD_F(fmt, __VA_ARGS__)
+#define DebugB(fmt, ...) UTILS_LOG_DISCARD_F(fmt, __VA_ARGS__)
+#define DebugR(rate, burst, msg) UTILS_LOG_DISCARD(msg)
+#define DebugS(n, msg) UTILS_LOG_DISCARD(msg)
+#define DebugJ(msg, ...) UTILS_LOG_DISCARD(msg)
+#endif
+
+#if UTILS_LOG_MIN_LEVEL <= UTILS_LOG_LEVEL_INFO
 #define InfoM(msg) Info(TEXT(__FUNCTION__), msg)
+#define InfoF(fmt, ...) Info(TEXT(__FUNCTION__), TEXT(fmt), __VA_ARGS__)
+#define InfoB(fmt, ...) LogBinary(_UTILS LogLevel::INFO, UTILS_LOG_SITE(fmt), TEXT(fmt), __VA_ARGS__)
+#define InfoR(rate, burst, msg) UTILS_LOG_RATE(_UTILS LogLevel::INFO, rate, burst, msg)
+#define InfoS(n, msg) UTILS_LOG_SAMPLE(_UTILS LogLevel::INFO, n, msg)
+#define InfoJ(msg, ...) LogFields(_UTILS LogLevel::INFO, TEXT(__FUNCTION__), msg, { __VA_ARGS__ })
+#else
+#define InfoM(msg) UTILS_LOG_DISCARD(msg)
+#define InfoF(fmt, ...) UTILS_LOG_DISCARD_F(fmt, __VA_ARGS__)
+#define InfoB(fmt, ...) UTILS_LOG_DISCARD_F(fmt, __VA_ARGS__)
+#define InfoR(rate, burst, msg) UTILS_LOG_DISCARD(msg)
+#define InfoS(n, msg) UTILS_LOG_DISCARD(msg)
+#define InfoJ(msg, ...) UTILS_LOG_DISCARD(msg)
+#endif
+
+#if UTILS_LOG_MIN_LEVEL <= UTILS_LOG_LEVEL_WARN
 #define WarnM(msg) Warn(TEXT(__FUNCTION__), msg)
+#define WarnF(fmt, ...) Warn(TEXT(__FUNCTION__), TEXT(fmt), __VA_ARGS__)
+#define WarnB(fmt, ...) LogBinary(_UTILS LogLevel::WARN, UTILS_LOG_SITE(fmt), TEXT(fmt), __VA_ARGS__)
+#define WarnR(rate, burst, msg) UTILS_LOG_RATE(_UTILS LogLevel::WARN, rate, burst, msg)
+#define WarnS(n, msg) UTILS_LOG_SAMPLE(_UTILS LogLevel::WARN, n, msg)
+#define WarnJ(msg, ...) LogFields(_UTILS LogLevel::WARN, TEXT(__FUNCTION__), msg, { __VA_ARGS__ })
+#else
+#define WarnM(msg) UTILS_LOG_DISCARD(msg)
+#define WarnF(fmt, ...) UTILS_LOG_DISCARD_F(fmt, __VA_ARGS__)
+#define WarnB(fmt, ...) UTILS_LOG_DISCARD_F(fmt, __VA_ARGS__)
+#define WarnR(rate, burst, msg) UTILS_LOG_DISCARD(msg)
+#define WarnS(n, msg) UTILS_LOG_DISCARD(msg)
+#define WarnJ(msg, ...) UTILS_LOG_DISCARD(msg)
+#endif
+
+#if UTILS_LOG_MIN_LEVEL <= UTILS_LOG_LEVEL_ERR
 #define ErrorM(msg) Error(TEXT(__FUNCTION__), msg)
+#define ErrorF(fmt, ...) Error(TEXT(__FUNCTION__), TEXT(fmt), __VA_ARGS__)
+#define ErrorB(fmt, ...) LogBinary(_UTILS LogLevel::ERR, UTILS_LOG_SITE(fmt), TEXT(fmt), __VA_ARGS__)
+#define ErrorR(rate, burst, msg) UTILS_LOG_RATE(_UTILS LogLevel::ERR, rate, burst, msg)
+#define ErrorS(n, msg) UTILS_LOG_SAMPLE(_UTILS LogLevel::ERR, n, msg)
+#define ErrorJ(msg, ...) LogFields(_UTILS LogLevel::ERR, TEXT(__FUNCTION__), msg, { __VA_ARGS__ })
+#else
+#define ErrorM(msg) UTILS_LOG_DISCARD(msg)
+#define ErrorF(fmt, ...) UTILS_LOG_DISCARD_F(fmt, __VA_ARGS__)
+#define ErrorB(fmt, ...) UTILS_LOG_DISCARD_F(fmt, __VA_ARGS__)
+#define ErrorR(rate, burst, msg) UTILS_LOG_DISCARD(msg)
+#define ErrorS(n, msg) UTILS_LOG_DISCARD(msg)
+#define ErrorJ(msg, ...) UTILS_LOG_DISCARD(msg)
+#endif
 
 _UTILS_END
 
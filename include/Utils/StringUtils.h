@@ -9,13 +9,34 @@
 
 #include <Windows.h>
 
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <concepts>
 #include <format>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
 #include <regex>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
+#include <version>
+
+#if __cpp_lib_expected >= 202202L
+#include <expected>
+#endif // __cpp_lib_expected
 
 #include "utils_def.h"
 
+// x64 与开启 /arch:SSE2 的 x86 上，字符扫描每次比较16个字节
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTILS_STRING_SSE2
+#include <emmintrin.h>
+#endif
+
 #define FORMAT(fmt, ...) std::format(TEXT(fmt), __VA_ARGS__)
 #define FORMAT_SZ(fmt, ...) FORMAT(fmt, __VA_ARGS__).c_str()
 
@@ -25,12 +46,270 @@
 _UTILS_BEGIN
 
 using String       = std::basic_string<TCHAR>;
+using StringView   = std::basic_string_view<TCHAR>;
 using StringList   = std::vector<String>;
 using Regex        = std::basic_regex<String::value_type>;
 using MatchResults = std::match_results<String::const_iterator>;
 
+/// <summary>
+/// 惰性分割的选项
+/// </summary>
+enum class SplitOptions : uint8_t {
+	NONE = 0,
+
+	/// <summary>
+	/// 跳过空片段，连续的分隔符视为一个
+	/// </summary>
+	SKIP_EMPTY = 1,
+};
+
+/// <summary>
+/// 编译期可构造的字符集合，用于按"其中任一字符"分割：每个码值占位图中的一位，判断与加入均为常数时间，字符个数不受限制。
+/// 不超过 MAX_VECTOR_CHARS 个字符时另按加入顺序记录各字符，查找时以 SSE2 每次比较16个字节。
+/// <para>char 的位图为32字节，UTF-16 的 wchar_t 覆盖整个 BMP，位图为 8 KiB。分割时只引用集合而不复制，宜以 constexpr 或 static 定义后复用</para>
+/// </summary>
+/// <typeparam name="_CharT">字符类型，至多两个字节</typeparam>
+template <typename _CharT>
+class BasicCharSet {
+	static_assert(sizeof(_CharT) <= 2, "BasicCharSet supports single-byte and UTF-16 character types only");
+
+public:
+	/// <summary>
+	/// 字符类型可表示的码值个数
+	/// </summary>
+	static constexpr size_t CODE_COUNT = size_t(1) << (8 * sizeof(_CharT));
+
+	/// <summary>
+	/// 可按字符并行比较的最大字符数，更大的集合逐个字符查位图
+	/// </summary>
+	static constexpr size_t MAX_VECTOR_CHARS = 8;
+
+private:
+	uint64_t m_arrBits_[CODE_COUNT / 64] {};
+
+	/// <summary>
+	/// 前 MAX_VECTOR_CHARS 个不同的字符及不同字符的总数
+	/// </summary>
+	_CharT m_arrChars_[MAX_VECTOR_CHARS] {};
+	size_t m_nSize_ = 0;
+
+	static const BasicCharSet BLANKS_;
+
+public:
+	constexpr BasicCharSet() noexcept = default;
+
+	/// <summary>
+	/// 由给定字符构造集合，以 constexpr 定义时位图在编译期生成
+	/// </summary>
+	/// <param name="p_svChars">集合中的字符</param>
+	constexpr BasicCharSet(std::basic_string_view<_CharT> p_svChars) noexcept {
+		for (_CharT ch : p_svChars) {
+			this->Add(ch);
+		}
+	}
+
+	constexpr BasicCharSet(const _CharT* p_cszChars) noexcept
+	    : BasicCharSet(std::basic_string_view<_CharT>(p_cszChars)) {
+	}
+
+	/// <summary>
+	/// 向集合中加入一个字符
+	/// </summary>
+	constexpr BasicCharSet& Add(_CharT p_ch) noexcept {
+		if (this->Contains(p_ch)) {
+			return *this;
+		}
+
+		const auto nCode = static_cast<std::make_unsigned_t<_CharT>>(p_ch);
+		m_arrBits_[nCode >> 6] |= uint64_t(1) << (nCode & 63);
+		if (m_nSize_ < MAX_VECTOR_CHARS) {
+			m_arrChars_[m_nSize_] = p_ch;
+		}
+		++m_nSize_;
+		return *this;
+	}
+
+	/// <summary>
+	/// 给定字符是否在集合中
+	/// </summary>
+	constexpr bool Contains(_CharT p_ch) const noexcept {
+		const auto nCode = static_cast<std::make_unsigned_t<_CharT>>(p_ch);
+		return ((m_arrBits_[nCode >> 6] >> (nCode & 63)) & 1) != 0;
+	}
+
+	/// <summary>
+	/// 集合中不同字符的个数
+	/// </summary>
+	constexpr size_t Size() const noexcept {
+		return m_nSize_;
+	}
+
+	/// <summary>
+	/// 字符不超过 MAX_VECTOR_CHARS 个时按加入顺序列出全部字符，否则为空
+	/// </summary>
+	constexpr std::basic_string_view<_CharT> GetVectorChars() const noexcept {
+		return m_nSize_ <= MAX_VECTOR_CHARS ? std::basic_string_view<_CharT>(m_arrChars_, m_nSize_) : std::basic_string_view<_CharT>();
+	}
+
+	/// <summary>
+	/// 空白字符：空格、'\t'、'\r'、'\n'、'\v'、'\f'
+	/// </summary>
+	static constexpr const BasicCharSet& Blanks() noexcept {
+		return BLANKS_;
+	}
+};
+
+template <typename _CharT>
+constexpr BasicCharSet<_CharT> BasicCharSet<_CharT>::BLANKS_ = BasicCharSet<_CharT>().Add(' ').Add('\t').Add('\r').Add('\n').Add('\v').Add('\f');
+
+using CharSet = BasicCharSet<TCHAR>;
+
+/// <summary>
+/// StringUtils::TryValueOf 失败的原因
+/// </summary>
+enum class ParseError : uint8_t {
+	/// <summary>
+	/// 开头不是数值，包括空串、前导空白与'+'号
+	/// </summary>
+	INVALID_FORMAT,
+
+	/// <summary>
+	/// 数值超出目标类型的范围
+	/// </summary>
+	OUT_OF_RANGE,
+
+	/// <summary>
+	/// 数值之后还有其他字符
+	/// </summary>
+	TRAILING_CHARACTERS,
+};
+
+#if __cpp_lib_expected >= 202202L
+template <typename _NumT>
+using ParseResult = std::expected<_NumT, ParseError>;
+#else
+/// <summary>
+/// 未启用 C++23 时 std::expected&lt;_NumT, ParseError&gt; 的替代，提供其读取结果所用的接口
+/// </summary>
+/// <typeparam name="_NumT">数值类型</typeparam>
+template <typename _NumT>
+class ParseResult {
+private:
+	_NumT m_value_ {};
+	ParseError m_error_ {};
+	bool m_bHasValue_;
+
+public:
+	constexpr ParseResult(_NumT p_value) noexcept
+	    : m_value_(p_value)
+	    , m_bHasValue_(true) {
+	}
+
+	constexpr explicit ParseResult(ParseError p_error) noexcept
+	    : m_error_(p_error)
+	    , m_bHasValue_(false) {
+	}
+
+	constexpr bool has_value() const noexcept {
+		return m_bHasValue_;
+	}
+
+	constexpr explicit operator bool() const noexcept {
+		return m_bHasValue_;
+	}
+
+	constexpr const _NumT& operator*() const noexcept {
+		return m_value_;
+	}
+
+	/// <summary>
+	/// 获取数值。与 std::expected::value 不同，没有数值时抛出 std::invalid_argument 而不是 std::bad_expected_access，
+	/// 升级到 C++23 后捕获该异常的代码需随之修改
+	/// </summary>
+	/// <exception cref="std::invalid_argument">没有数值时抛出</exception>
+	constexpr const _NumT& value() const {
+		if (!m_bHasValue_) {
+			throw std::invalid_argument("ParseResult has no value");
+		}
+		return m_value_;
+	}
+
+	constexpr _NumT value_or(_NumT p_default) const noexcept {
+		return m_bHasValue_ ? m_value_ : p_default;
+	}
+
+	constexpr ParseError error() const noexcept {
+		return m_error_;
+	}
+};
+#endif // __cpp_lib_expected
+
+template <typename _CharT, typename _SepT = std::basic_string_view<_CharT>>
+class BasicSplitRange;
+
 class UTILS_API StringUtils {
+	template <typename, typename>
+	friend class BasicSplitRange;
+
+private:
+	/// <summary>
+	/// 可由 std::to_chars 与 std::from_chars 转换的数值类型，即 bool 与字符类型之外的算术类型
+	/// </summary>
+	template <typename _NumT>
+	static constexpr bool IS_PLAIN_NUMBER_ = std::is_arithmetic_v<_NumT> && !std::_Is_any_of_v<_NumT, bool, char, wchar_t, char8_t, char16_t, char32_t>;
+
 public:
+	/// <summary>
+	/// TryValueOf 接受的宽字符串的最大长度，收窄后的字符放在栈上的缓冲中
+	/// </summary>
+	static constexpr size_t MAX_WIDE_NUMBER_LENGTH = 128;
+
+	/// <summary>
+	/// 在头和尾去掉空格、'\r'、'\n'及给定串中的任何一个，不复制字符串，返回的视图引用原有数据
+	/// </summary>
+	/// <typeparam name="_CharT">字符串字符类型</typeparam>
+	/// <param name="p_sv">将要处理的字符串</param>
+	/// <param name="pc_lists">自定义去除的串，空串被忽略</param>
+	/// <returns>处理过后的字符串视图</returns>
+	template <typename _CharT>
+	static std::basic_string_view<_CharT> TrimView(
+	    std::basic_string_view<_CharT> p_sv, std::initializer_list<std::type_identity_t<std::basic_string_view<_CharT>>> pc_lists = {}) {
+		return TrimAffixes_(p_sv, pc_lists);
+	}
+
+	template <typename _CharT>
+	static std::basic_string_view<_CharT> TrimView(
+	    const std::basic_string<_CharT>& pc_str, std::initializer_list<std::type_identity_t<std::basic_string_view<_CharT>>> pc_lists = {}) {
+		return TrimAffixes_(std::basic_string_view<_CharT>(pc_str), pc_lists);
+	}
+
+	template <typename _CharT>
+	static std::basic_string_view<_CharT> TrimView(
+	    const _CharT* pc_szValue, std::initializer_list<std::type_identity_t<std::basic_string_view<_CharT>>> pc_lists = {}) {
+		return TrimAffixes_(std::basic_string_view<_CharT>(pc_szValue), pc_lists);
+	}
+
+	/// <summary>
+	/// 返回的视图会引用已销毁的临时字符串，改用 Trim 或 TrimInPlace
+	/// </summary>
+	template <typename _CharT>
+	static std::basic_string_view<_CharT> TrimView(
+	    std::basic_string<_CharT>&& p_str, std::initializer_list<std::type_identity_t<std::basic_string_view<_CharT>>> pc_lists = {}) = delete;
+
+	/// <summary>
+	/// 在头和尾去掉空格、'\r'、'\n'及给定串中的任何一个，直接修改给定字符串，不重新分配内存
+	/// </summary>
+	/// <typeparam name="_CharT">字符串字符类型</typeparam>
+	/// <param name="p_str">将要处理的字符串</param>
+	/// <param name="pc_lists">自定义去除的串，空串被忽略</param>
+	template <typename _CharT>
+	static void TrimInPlace(std::basic_string<_CharT>& p_str, std::initializer_list<std::type_identity_t<std::basic_string_view<_CharT>>> pc_lists = {}) {
+		const std::basic_string_view<_CharT> sv = TrimAffixes_(std::basic_string_view<_CharT>(p_str), pc_lists);
+		const size_t nBegin                     = static_cast<size_t>(sv.data() - p_str.data());
+		p_str.erase(nBegin + sv.size());
+		p_str.erase(0, nBegin);
+	}
+
 	/// <summary>
 	/// 使用给定字符串组，并在头和尾去掉满足给定数据的中的任何一个，不改变原因字符串
 	/// </summary>
@@ -41,57 +320,7 @@ public:
 	template <typename _CharT>
 	static std::basic_string<_CharT> Trim(
 	    const std::basic_string<_CharT>& pc_str, std::initializer_list<const std::basic_string<_CharT>> pc_lists = {}) {
-		std::basic_string<_CharT> res { pc_str };
-		if (res.empty())
-			return res;
-
-		size_t nLen;
-		bool bFlag = true;
-		while ((nLen = res.size()) > 0 && bFlag) {
-			bFlag = false;
-			switch (res[0]) {
-				case _CharT(' '):
-				case _CharT('\r'):
-				case _CharT('\n'):
-					bFlag = true;
-					res.erase(0, 1);
-					break;
-				default: {
-					for (auto& item : pc_lists) {
-						if (res.starts_with(item)) {
-							res.erase(0, item.size());
-							bFlag = true;
-							break; // for
-						}
-					}
-					break; // switch
-				}
-			}
-
-			if (nLen == 0) {
-				break;
-			}
-
-			switch (res[nLen - 1]) {
-				case _CharT(' '):
-				case _CharT('\r'):
-				case _CharT('\n'):
-					bFlag = true;
-					res.erase(nLen - 1, 1);
-					break;
-				default: {
-					for (auto& item : pc_lists) {
-						if (res.ends_with(item)) {
-							res.erase(nLen - item.size(), item.size());
-							bFlag = true;
-							break; // for
-						}
-					}
-					break; // switch
-				}
-			}
-		}
-		return res;
+		return std::basic_string<_CharT>(TrimAffixes_(std::basic_string_view<_CharT>(pc_str), pc_lists));
 	}
 
 	/// <summary>
@@ -102,11 +331,7 @@ public:
 	/// <returns>处理后的字符串</returns>
 	template <typename _CharT>
 	static std::basic_string<_CharT> Trim(const _CharT* pc_szTrimValue, std::initializer_list<const std::basic_string<_CharT>>&& pc_lists = {}) {
-		/*if (nullptr == pc_szTrimValue) {
-		    throw NullPointerReferenceException(TEXT("pc_szTrimValue"));
-		}*/
-		return Trim<_CharT>(
-		    std::basic_string<_CharT> { pc_szTrimValue }, std::forward<std::initializer_list<const std::basic_string<_CharT>>>(pc_lists));
+		return std::basic_string<_CharT>(TrimAffixes_(std::basic_string_view<_CharT>(pc_szTrimValue), pc_lists));
 	}
 
 	/// <summary>
@@ -147,30 +372,125 @@ public:
 	}
 
 	/// <summary>
-	/// 用给定字符串作为连接符，连接给定的字符串数组
+	/// 惰性地分割给定字符串，每次迭代才查找下一个分隔符，片段为引用原有数据的视图，不分配内存。
+	/// <para>n 个分隔符产生 n+1 个片段，开头、结尾及相邻的分隔符之间为空片段；单字符分隔符按16字节并行查找</para>
 	/// </summary>
 	/// <typeparam name="_CharT">字符串的字符类型</typeparam>
-	/// <param name="pc_vstrValues">将要连接的字符串</param>
-	/// <param name="p_cszSperator">连接符</param>
+	/// <param name="p_svValue">将要分割的字符串，需在遍历期间保持有效</param>
+	/// <param name="p_svSep">分隔符，为空时整个字符串作为一个片段。与被分割的字符串一样只被引用，需在遍历期间保持有效，不接受临时字符串</param>
+	/// <param name="p_options">分割选项</param>
+	/// <param name="p_nMaxSplits">最多分割的次数，达到后剩余部分作为最后一个片段，被跳过的空片段不计入</param>
+	/// <returns>可用于范围 for 与 std::ranges 算法的前向范围</returns>
+	template <typename _CharT>
+	static BasicSplitRange<_CharT> SplitView(std::basic_string_view<_CharT> p_svValue, std::type_identity_t<std::basic_string_view<_CharT>> p_svSep,
+	    SplitOptions p_options = SplitOptions::NONE, size_t p_nMaxSplits = SIZE_MAX) noexcept {
+		return BasicSplitRange<_CharT>(p_svValue, p_svSep, p_options, p_nMaxSplits);
+	}
+
+	template <typename _CharT>
+	static BasicSplitRange<_CharT> SplitView(const std::basic_string<_CharT>& pc_strValue, std::type_identity_t<std::basic_string_view<_CharT>> p_svSep,
+	    SplitOptions p_options = SplitOptions::NONE, size_t p_nMaxSplits = SIZE_MAX) noexcept {
+		return BasicSplitRange<_CharT>(pc_strValue, p_svSep, p_options, p_nMaxSplits);
+	}
+
+	template <typename _CharT>
+	static BasicSplitRange<_CharT> SplitView(std::basic_string<_CharT>&& p_strValue, std::type_identity_t<std::basic_string_view<_CharT>> p_svSep,
+	    SplitOptions p_options = SplitOptions::NONE, size_t p_nMaxSplits = SIZE_MAX) = delete;
+
+	template <typename _CharT, typename _SepT, typename = std::enable_if_t<std::is_same_v<_SepT, std::basic_string<_CharT>>>>
+	static BasicSplitRange<_CharT> SplitView(std::basic_string_view<_CharT> p_svValue, _SepT&& p_strSep, SplitOptions p_options = SplitOptions::NONE,
+	    size_t p_nMaxSplits = SIZE_MAX) = delete;
+
+	template <typename _CharT, typename _SepT, typename = std::enable_if_t<std::is_same_v<_SepT, std::basic_string<_CharT>>>>
+	static BasicSplitRange<_CharT> SplitView(const std::basic_string<_CharT>& pc_strValue, _SepT&& p_strSep, SplitOptions p_options = SplitOptions::NONE,
+	    size_t p_nMaxSplits = SIZE_MAX) = delete;
+
+	/// <summary>
+	/// 惰性地按字符集合中的任一字符分割给定字符串，每个字符只查一次位图，用法与 SplitView 相同。
+	/// <para>按空白连续出现的位置分割时使用 CharSet::Blanks() 与 SplitOptions::SKIP_EMPTY</para>
+	/// </summary>
+	/// <typeparam name="_CharT">字符串的字符类型</typeparam>
+	/// <param name="p_svValue">将要分割的字符串，需在遍历期间保持有效</param>
+	/// <param name="pc_seps">分隔字符的集合，只被引用，需比返回的范围及其迭代器存活得更久，不接受临时集合。宜定义为 constexpr 常量以在编译期生成位图</param>
+	/// <param name="p_options">分割选项</param>
+	/// <param name="p_nMaxSplits">最多分割的次数，达到后剩余部分作为最后一个片段，被跳过的空片段不计入</param>
+	/// <returns>可用于范围 for 与 std::ranges 算法的前向范围</returns>
+	template <typename _CharT>
+	static BasicSplitRange<_CharT, BasicCharSet<_CharT>> SplitAnyOf(std::basic_string_view<_CharT> p_svValue,
+	    const std::type_identity_t<BasicCharSet<_CharT>>& pc_seps, SplitOptions p_options = SplitOptions::NONE, size_t p_nMaxSplits = SIZE_MAX) noexcept {
+		return BasicSplitRange<_CharT, BasicCharSet<_CharT>>(p_svValue, pc_seps, p_options, p_nMaxSplits);
+	}
+
+	template <typename _CharT>
+	static BasicSplitRange<_CharT, BasicCharSet<_CharT>> SplitAnyOf(const std::basic_string<_CharT>& pc_strValue,
+	    const std::type_identity_t<BasicCharSet<_CharT>>& pc_seps, SplitOptions p_options = SplitOptions::NONE, size_t p_nMaxSplits = SIZE_MAX) noexcept {
+		return BasicSplitRange<_CharT, BasicCharSet<_CharT>>(pc_strValue, pc_seps, p_options, p_nMaxSplits);
+	}
+
+	template <typename _CharT>
+	static BasicSplitRange<_CharT, BasicCharSet<_CharT>> SplitAnyOf(std::basic_string<_CharT>&& p_strValue,
+	    const std::type_identity_t<BasicCharSet<_CharT>>& pc_seps, SplitOptions p_options = SplitOptions::NONE, size_t p_nMaxSplits = SIZE_MAX) = delete;
+
+	template <typename _CharT>
+	static BasicSplitRange<_CharT, BasicCharSet<_CharT>> SplitAnyOf(std::basic_string_view<_CharT> p_svValue,
+	    std::type_identity_t<BasicCharSet<_CharT>>&& p_seps, SplitOptions p_options = SplitOptions::NONE, size_t p_nMaxSplits = SIZE_MAX) = delete;
+
+	template <typename _CharT>
+	static BasicSplitRange<_CharT, BasicCharSet<_CharT>> SplitAnyOf(const std::basic_string<_CharT>& pc_strValue,
+	    std::type_identity_t<BasicCharSet<_CharT>>&& p_seps, SplitOptions p_options = SplitOptions::NONE, size_t p_nMaxSplits = SIZE_MAX) = delete;
+
+	/// <summary>
+	/// 用给定字符串作为连接符，连接给定范围中的元素。元素可以是字符串、字符串视图或数值，数值经 std::to_chars 直接写入结果。
+	/// <para>先遍历一次计算结果的长度（浮点数按上限计），只分配一次内存，再遍历一次写入</para>
+	/// </summary>
+	/// <typeparam name="_RangeT">可多次遍历的范围类型</typeparam>
+	/// <typeparam name="_CharT">字符串的字符类型</typeparam>
+	/// <param name="pc_values">将要连接的元素</param>
+	/// <param name="p_svSeparator">连接符</param>
 	/// <returns>连接后的字符串</returns>
-	template <class _CharT>
-	static std::basic_string<_CharT> Join(const std::vector<std::basic_string<_CharT>>& pc_vstrValues, const _CharT* p_cszSperator) {
-		if (0 == pc_vstrValues.size()) {
-			return std::basic_string<_CharT>();
+	template <std::ranges::forward_range _RangeT, typename _CharT>
+	static std::basic_string<_CharT> Join(const _RangeT& pc_values, std::basic_string_view<_CharT> p_svSeparator) {
+		size_t nSize  = 0;
+		size_t nCount = 0;
+		for (const auto& item : pc_values) {
+			nSize += GetJoinedSize_<_CharT>(item);
+			++nCount;
 		}
 
-		if (1 == pc_vstrValues.size()) {
-			return pc_vstrValues[0];
+		std::basic_string<_CharT> strRes;
+		if (nCount == 0) {
+			return strRes;
 		}
+		strRes.resize(nSize + (nCount - 1) * p_svSeparator.size());
 
-		std::basic_string<_CharT> strRes;
-		std::for_each_n(pc_vstrValues.begin(), pc_vstrValues.size() - 1,
-		    [&strRes, &p_cszSperator](const auto& strItem) { strRes.append(strItem + p_cszSperator); });
-		strRes.append(pc_vstrValues[pc_vstrValues.size() - 1]);
+		_CharT* pOut       = strRes.data();
+		_CharT* const pEnd = strRes.data() + strRes.size();
+		bool bFirst        = true;
+		for (const auto& item : pc_values) {
+			if (!bFirst) {
+				pOut = std::char_traits<_CharT>::copy(pOut, p_svSeparator.data(), p_svSeparator.size()) + p_svSeparator.size();
+			}
+			bFirst = false;
+			pOut   = WriteJoined_(pOut, pEnd, item);
+		}
 
+		strRes.resize(static_cast<size_t>(pOut - strRes.data()));
 		return strRes;
 	}
 
+	/// <summary>
+	/// 用给定字符串作为连接符，连接给定范围中的元素
+	/// </summary>
+	/// <typeparam name="_RangeT">可多次遍历的范围类型</typeparam>
+	/// <typeparam name="_CharT">字符串的字符类型</typeparam>
+	/// <param name="pc_values">将要连接的元素</param>
+	/// <param name="p_cszSeparator">连接符</param>
+	/// <returns>连接后的字符串</returns>
+	template <std::ranges::forward_range _RangeT, typename _CharT>
+	static std::basic_string<_CharT> Join(const _RangeT& pc_values, const _CharT* p_cszSeparator) {
+		return Join(pc_values, std::basic_string_view<_CharT>(p_cszSeparator));
+	}
+
 	/// <summary>
 	/// 尝试将字符串转为指定的数值类型
 	/// </summary>
@@ -209,6 +529,47 @@ public:
 		return ValueOf<_T>(std::basic_string<_CharT>(p_cszValue), p_nBase);
 	}
 
+	/// <summary>
+	/// 将字符串转为指定的数值类型，失败时返回错误而不抛出异常。基于 std::from_chars，与区域设置无关，不跳过空白，整个字符串需恰好为一个数值
+	/// </summary>
+	/// <typeparam name="_NumT">整数或浮点类型</typeparam>
+	/// <typeparam name="_CharT">字符串的字符类型</typeparam>
+	/// <param name="p_svValue">将要转换的字符串，宽字符串按ASCII收窄到栈上的缓冲后解析，超过 MAX_WIDE_NUMBER_LENGTH 个字符时返回 INVALID_FORMAT</param>
+	/// <param name="p_nBase">整数的进制；浮点数为16时按十六进制解析，否则按十进制或科学计数法解析</param>
+	/// <returns>转换后的数值或失败的原因</returns>
+	template <typename _NumT, typename _CharT, typename = std::enable_if_t<IS_PLAIN_NUMBER_<_NumT>>>
+	static ParseResult<_NumT> TryValueOf(std::basic_string_view<_CharT> p_svValue, int p_nBase = 10) noexcept {
+		if constexpr (sizeof(_CharT) == 1) {
+			return ParseNumber_<_NumT>(reinterpret_cast<const char*>(p_svValue.data()), p_svValue.size(), p_nBase);
+		} else {
+			if (p_svValue.size() > MAX_WIDE_NUMBER_LENGTH) {
+#if __cpp_lib_expected >= 202202L
+				return std::unexpected(ParseError::INVALID_FORMAT);
+#else
+				return ParseResult<_NumT>(ParseError::INVALID_FORMAT);
+#endif // __cpp_lib_expected
+			}
+
+			// 非ASCII字符收窄为 from_chars 不接受的字符，避免截断后恰好成为数字
+			char szNarrow[MAX_WIDE_NUMBER_LENGTH];
+			for (size_t idx = 0; idx < p_svValue.size(); ++idx) {
+				const auto nCode = static_cast<std::make_unsigned_t<_CharT>>(p_svValue[idx]);
+				szNarrow[idx]    = nCode < 0x80 ? static_cast<char>(nCode) : '\x7F';
+			}
+			return ParseNumber_<_NumT>(szNarrow, p_svValue.size(), p_nBase);
+		}
+	}
+
+	template <typename _NumT, typename _CharT, typename = std::enable_if_t<IS_PLAIN_NUMBER_<_NumT>>>
+	static ParseResult<_NumT> TryValueOf(const std::basic_string<_CharT>& pc_strValue, int p_nBase = 10) noexcept {
+		return TryValueOf<_NumT>(std::basic_string_view<_CharT>(pc_strValue), p_nBase);
+	}
+
+	template <typename _NumT, typename _CharT, typename = std::enable_if_t<IS_PLAIN_NUMBER_<_NumT>>>
+	static ParseResult<_NumT> TryValueOf(const _CharT* p_cszValue, int p_nBase = 10) noexcept {
+		return TryValueOf<_NumT>(std::basic_string_view<_CharT>(p_cszValue), p_nBase);
+	}
+
 	/// <summary>
 	/// 将给定的数值类型转为字符串
 	/// </summary>
@@ -240,6 +601,14 @@ public:
 	/// <returns>转换后的字符串</returns>
 	static std::string WideCharToMultiByte(const std::wstring& pc_wstr, int p_nCodePage = CP_UTF8);
 
+	/// <summary>
+	/// 将宽字节字符串按UTF-8编码追加到给定字节串，不经过区域设置与中间字符串，纯ASCII部分每次处理4个字符。
+	/// 不成对的代理项被替换为U+FFFD
+	/// </summary>
+	/// <param name="p_strOut">输出字节串</param>
+	/// <param name="p_wsvText">将要转换的字符串</param>
+	static void AppendUtf8(std::string& p_strOut, std::wstring_view p_wsvText);
+
 	/// <summary>
 	/// 将给定字符串转当前平台使用的编码方式的字符串
 	/// </summary>
@@ -257,6 +626,439 @@ public:
 #endif // _UNICODE
 		}
 	}
+
+private:
+	template <typename _NumT>
+	static ParseResult<_NumT> ParseNumber_(const char* p_pBegin, size_t p_nSize, int p_nBase) noexcept {
+		const char* pEnd = p_pBegin + p_nSize;
+
+		_NumT value {};
+		std::from_chars_result result;
+		if constexpr (std::is_floating_point_v<_NumT>) {
+			result = std::from_chars(p_pBegin, pEnd, value, p_nBase == 16 ? std::chars_format::hex : std::chars_format::general);
+		} else {
+			result = std::from_chars(p_pBegin, pEnd, value, p_nBase);
+		}
+
+		ParseError error;
+		if (result.ec == std::errc::invalid_argument) {
+			error = ParseError::INVALID_FORMAT;
+		} else if (result.ec == std::errc::result_out_of_range) {
+			error = ParseError::OUT_OF_RANGE;
+		} else if (result.ptr != pEnd) {
+			error = ParseError::TRAILING_CHARACTERS;
+		} else {
+			return value;
+		}
+
+#if __cpp_lib_expected >= 202202L
+		return std::unexpected(error);
+#else
+		return ParseResult<_NumT>(error);
+#endif // __cpp_lib_expected
+	}
+
+	template <typename _CharT>
+	static constexpr bool IsBlank_(_CharT p_ch) noexcept {
+		return p_ch == _CharT(' ') || p_ch == _CharT('\r') || p_ch == _CharT('\n');
+	}
+
+#ifdef UTILS_STRING_SSE2
+	/// <summary>
+	/// 16个字节中每个空白字符对应的 movemask 位为1，宽字符占2位
+	/// </summary>
+	template <typename _CharT>
+	static unsigned BlankMask_(const _CharT* p_pData) noexcept {
+		const __m128i vData = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pData));
+		if constexpr (sizeof(_CharT) == 1) {
+			const __m128i vMatch = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(vData, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(vData, _mm_set1_epi8('\r'))),
+			    _mm_cmpeq_epi8(vData, _mm_set1_epi8('\n')));
+			return static_cast<unsigned>(_mm_movemask_epi8(vMatch));
+		} else {
+			const __m128i vMatch = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(vData, _mm_set1_epi16(' ')), _mm_cmpeq_epi16(vData, _mm_set1_epi16('\r'))),
+			    _mm_cmpeq_epi16(vData, _mm_set1_epi16('\n')));
+			return static_cast<unsigned>(_mm_movemask_epi8(vMatch));
+		}
+	}
+#endif // UTILS_STRING_SSE2
+
+	/// <summary>
+	/// 给定字符第一次出现的位置，不存在时为 p_nSize
+	/// </summary>
+	template <typename _CharT>
+	static size_t FindChar_(const _CharT* p_pData, size_t p_nSize, _CharT p_ch) noexcept {
+		size_t idx = 0;
+#ifdef UTILS_STRING_SSE2
+		if constexpr (sizeof(_CharT) <= 2) {
+			constexpr size_t nLanes = 16 / sizeof(_CharT);
+			const __m128i vCh       = sizeof(_CharT) == 1 ? _mm_set1_epi8(static_cast<char>(p_ch)) : _mm_set1_epi16(static_cast<short>(p_ch));
+			for (; idx + nLanes <= p_nSize; idx += nLanes) {
+				const __m128i vData  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pData + idx));
+				const __m128i vMatch = sizeof(_CharT) == 1 ? _mm_cmpeq_epi8(vData, vCh) : _mm_cmpeq_epi16(vData, vCh);
+				const unsigned nMask = static_cast<unsigned>(_mm_movemask_epi8(vMatch));
+				if (nMask != 0) {
+					return idx + std::countr_zero(nMask) / sizeof(_CharT);
+				}
+			}
+		}
+#endif // UTILS_STRING_SSE2
+		while (idx < p_nSize && p_pData[idx] != p_ch) {
+			++idx;
+		}
+		return idx;
+	}
+
+	/// <summary>
+	/// 给定串从 p_nFrom 起第一次出现的位置，不存在时为 npos。按首字符并行查找候选位置后再比较其余字符
+	/// </summary>
+	template <typename _CharT>
+	static size_t FindSeparator_(std::basic_string_view<_CharT> p_svValue, std::basic_string_view<_CharT> p_svSep, size_t p_nFrom) noexcept {
+		while (p_nFrom + p_svSep.size() <= p_svValue.size()) {
+			const size_t nLast = p_svValue.size() - p_svSep.size() + 1;
+			const size_t nPos  = p_nFrom + FindChar_(p_svValue.data() + p_nFrom, nLast - p_nFrom, p_svSep[0]);
+			if (nPos == nLast) {
+				break;
+			}
+			if (std::char_traits<_CharT>::compare(p_svValue.data() + nPos + 1, p_svSep.data() + 1, p_svSep.size() - 1) == 0) {
+				return nPos;
+			}
+			p_nFrom = nPos + 1;
+		}
+		return std::basic_string_view<_CharT>::npos;
+	}
+
+	/// <summary>
+	/// 浮点数按最短表示写出时的长度上限，如"-2.2250738585072014e-308"
+	/// </summary>
+	static constexpr size_t MAX_FLOAT_CHARS = 32;
+
+	/// <summary>
+	/// 元素写入后的长度，字符串与整数为准确值，浮点数为上限
+	/// </summary>
+	template <typename _CharT, typename _ItemT>
+	static size_t GetJoinedSize_(const _ItemT& pc_item) noexcept {
+		if constexpr (std::is_convertible_v<const _ItemT&, std::basic_string_view<_CharT>>) {
+			return std::basic_string_view<_CharT>(pc_item).size();
+		} else if constexpr (IS_PLAIN_NUMBER_<_ItemT> && std::is_integral_v<_ItemT>) {
+			using Unsigned = std::make_unsigned_t<_ItemT>;
+
+			Unsigned nValue = static_cast<Unsigned>(pc_item);
+			size_t nDigits  = 1;
+			if constexpr (std::is_signed_v<_ItemT>) {
+				if (pc_item < 0) {
+					nValue = static_cast<Unsigned>(Unsigned(0) - nValue);
+					++nDigits;
+				}
+			}
+			for (; nValue >= 10; nValue /= 10) {
+				++nDigits;
+			}
+			return nDigits;
+		} else {
+			static_assert(IS_PLAIN_NUMBER_<_ItemT>, "Join elements must be strings, string views or numbers");
+			return MAX_FLOAT_CHARS;
+		}
+	}
+
+	/// <summary>
+	/// 写入一个元素，p_pEnd 为输出缓冲的实际末尾，按 GetJoinedSize_ 分配的缓冲中剩余空间总能容纳该元素
+	/// </summary>
+	template <typename _CharT, typename _ItemT>
+	static _CharT* WriteJoined_(_CharT* p_pOut, [[maybe_unused]] _CharT* p_pEnd, const _ItemT& pc_item) noexcept {
+		if constexpr (std::is_convertible_v<const _ItemT&, std::basic_string_view<_CharT>>) {
+			const std::basic_string_view<_CharT> svItem(pc_item);
+			return std::char_traits<_CharT>::copy(p_pOut, svItem.data(), svItem.size()) + svItem.size();
+		} else if constexpr (std::is_same_v<_CharT, char>) {
+			return std::to_chars(p_pOut, p_pEnd, pc_item).ptr;
+		} else {
+			// 数字均为ASCII，先写入栈上的缓冲区再逐个扩展
+			char szDigits[MAX_FLOAT_CHARS];
+			const char* pEnd = std::to_chars(szDigits, szDigits + MAX_FLOAT_CHARS, pc_item).ptr;
+			for (const char* pDigit = szDigits; pDigit < pEnd; ++pDigit) {
+				*p_pOut++ = static_cast<_CharT>(*pDigit);
+			}
+			return p_pOut;
+		}
+	}
+
+	/// <summary>
+	/// 集合中任一字符第一次出现的位置，不存在时为 p_nSize。每次处理4个字符以减少循环判断
+	/// </summary>
+	template <typename _CharT>
+	static size_t FindAnyOf_(const _CharT* p_pData, size_t p_nSize, const BasicCharSet<_CharT>& pc_set) noexcept {
+		size_t idx = 0;
+#ifdef UTILS_STRING_SSE2
+		// SSE2 没有按字节查表的指令，小集合与每个字符分别比较后合并，大集合仍查位图
+		const std::basic_string_view<_CharT> svChars = pc_set.GetVectorChars();
+		if (!svChars.empty()) {
+			constexpr size_t nLanes = 16 / sizeof(_CharT);
+			__m128i arrChars[BasicCharSet<_CharT>::MAX_VECTOR_CHARS];
+			for (size_t idxChar = 0; idxChar < svChars.size(); ++idxChar) {
+				const _CharT ch   = svChars[idxChar];
+				arrChars[idxChar] = sizeof(_CharT) == 1 ? _mm_set1_epi8(static_cast<char>(ch)) : _mm_set1_epi16(static_cast<short>(ch));
+			}
+			for (; idx + nLanes <= p_nSize; idx += nLanes) {
+				const __m128i vData = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pData + idx));
+				__m128i vMatch      = _mm_setzero_si128();
+				for (size_t idxChar = 0; idxChar < svChars.size(); ++idxChar) {
+					const __m128i vChar = arrChars[idxChar];
+					vMatch              = _mm_or_si128(vMatch, sizeof(_CharT) == 1 ? _mm_cmpeq_epi8(vData, vChar) : _mm_cmpeq_epi16(vData, vChar));
+				}
+				const unsigned nMask = static_cast<unsigned>(_mm_movemask_epi8(vMatch));
+				if (nMask != 0) {
+					return idx + std::countr_zero(nMask) / sizeof(_CharT);
+				}
+			}
+		}
+#endif // UTILS_STRING_SSE2
+		for (; idx + 4 <= p_nSize; idx += 4) {
+			if (pc_set.Contains(p_pData[idx]) | pc_set.Contains(p_pData[idx + 1]) | pc_set.Contains(p_pData[idx + 2]) | pc_set.Contains(p_pData[idx + 3])) {
+				break;
+			}
+		}
+		while (idx < p_nSize && !pc_set.Contains(p_pData[idx])) {
+			++idx;
+		}
+		return idx;
+	}
+
+	/// <summary>
+	/// 第一个非空白字符的位置，全为空白时为 p_nSize
+	/// </summary>
+	template <typename _CharT>
+	static size_t FindFirstNotBlank_(const _CharT* p_pData, size_t p_nSize) noexcept {
+		size_t idx = 0;
+#ifdef UTILS_STRING_SSE2
+		if constexpr (sizeof(_CharT) <= 2) {
+			constexpr size_t nLanes = 16 / sizeof(_CharT);
+			for (; idx + nLanes <= p_nSize; idx += nLanes) {
+				const unsigned nMask = BlankMask_(p_pData + idx);
+				if (nMask != 0xFFFF) {
+					return idx + std::countr_one(nMask) / sizeof(_CharT);
+				}
+			}
+		}
+#endif // UTILS_STRING_SSE2
+		while (idx < p_nSize && IsBlank_(p_pData[idx])) {
+			++idx;
+		}
+		return idx;
+	}
+
+	/// <summary>
+	/// 最后一个非空白字符之后的位置，全为空白时为0
+	/// </summary>
+	template <typename _CharT>
+	static size_t FindLastNotBlank_(const _CharT* p_pData, size_t p_nSize) noexcept {
+		size_t nEnd = p_nSize;
+#ifdef UTILS_STRING_SSE2
+		if constexpr (sizeof(_CharT) <= 2) {
+			constexpr size_t nLanes = 16 / sizeof(_CharT);
+			for (; nEnd >= nLanes; nEnd -= nLanes) {
+				const unsigned nMask = BlankMask_(p_pData + nEnd - nLanes);
+				if (nMask != 0xFFFF) {
+					return nEnd - std::countl_one(static_cast<uint16_t>(nMask)) / sizeof(_CharT);
+				}
+			}
+		}
+#endif // UTILS_STRING_SSE2
+		while (nEnd > 0 && IsBlank_(p_pData[nEnd - 1])) {
+			--nEnd;
+		}
+		return nEnd;
+	}
+
+	/// <summary>
+	/// 交替去掉空白与给定的串，直到两端都不再变化
+	/// </summary>
+	template <typename _CharT, typename _AffixT>
+	static std::basic_string_view<_CharT> TrimAffixes_(std::basic_string_view<_CharT> p_sv, std::initializer_list<_AffixT> pc_lists) noexcept {
+		using View = std::basic_string_view<_CharT>;
+
+		for (;;) {
+			p_sv.remove_prefix(FindFirstNotBlank_(p_sv.data(), p_sv.size()));
+			const auto iter = std::find_if(pc_lists.begin(), pc_lists.end(), [&p_sv](const _AffixT& pc_affix) {
+				const View svAffix(pc_affix);
+				return !svAffix.empty() && p_sv.starts_with(svAffix);
+			});
+			if (iter == pc_lists.end()) {
+				break;
+			}
+			p_sv.remove_prefix(View(*iter).size());
+		}
+
+		for (;;) {
+			p_sv.remove_suffix(p_sv.size() - FindLastNotBlank_(p_sv.data(), p_sv.size()));
+			const auto iter = std::find_if(pc_lists.begin(), pc_lists.end(), [&p_sv](const _AffixT& pc_affix) {
+				const View svAffix(pc_affix);
+				return !svAffix.empty() && p_sv.ends_with(svAffix);
+			});
+			if (iter == pc_lists.end()) {
+				break;
+			}
+			p_sv.remove_suffix(View(*iter).size());
+		}
+		return p_sv;
+	}
+};
+
+/// <summary>
+/// StringUtils::SplitView 与 SplitAnyOf 返回的惰性分割范围。
+/// <para>被分割的字符串、分隔符串及字符集合均只被引用，需在遍历期间保持有效；迭代器复制范围的状态，不依赖范围对象本身</para>
+/// </summary>
+/// <typeparam name="_CharT">字符串的字符类型</typeparam>
+/// <typeparam name="_SepT">分隔符串或分隔字符的集合</typeparam>
+template <typename _CharT, typename _SepT>
+class BasicSplitRange : public std::ranges::view_interface<BasicSplitRange<_CharT, _SepT>> {
+public:
+	using View = std::basic_string_view<_CharT>;
+
+private:
+	static constexpr bool IS_CHAR_SET = std::is_same_v<_SepT, BasicCharSet<_CharT>>;
+
+	/// <summary>
+	/// 分割所需的全部状态
+	/// </summary>
+	struct State_ {
+		View svValue;
+
+		/// <summary>
+		/// 字符集合只保存指针，避免复制位图
+		/// </summary>
+		std::conditional_t<IS_CHAR_SET, const _SepT*, _SepT> sep {};
+		size_t nMaxSplits = SIZE_MAX;
+		bool bSkipEmpty   = false;
+
+		size_t GetSeparatorSize() const noexcept {
+			if constexpr (IS_CHAR_SET) {
+				return 1;
+			} else {
+				return sep.size();
+			}
+		}
+
+		size_t Find(size_t p_nFrom) const noexcept {
+			size_t nPos;
+			if constexpr (IS_CHAR_SET) {
+				nPos = p_nFrom + StringUtils::FindAnyOf_(svValue.data() + p_nFrom, svValue.size() - p_nFrom, *sep);
+			} else if (sep.size() == 1) {
+				nPos = p_nFrom + StringUtils::FindChar_(svValue.data() + p_nFrom, svValue.size() - p_nFrom, sep[0]);
+			} else {
+				return sep.empty() ? View::npos : StringUtils::FindSeparator_(svValue, sep, p_nFrom);
+			}
+			return nPos == svValue.size() ? View::npos : nPos;
+		}
+	};
+
+	State_ m_state_;
+
+public:
+	class Iterator {
+	private:
+		State_ m_state_ {};
+		View m_svCurrent_;
+
+		/// <summary>
+		/// 下一个片段的起始位置，npos 表示当前片段为最后一个
+		/// </summary>
+		size_t m_nNext_   = View::npos;
+		size_t m_nSplits_ = 0;
+		bool m_bEnd_      = true;
+
+		void Advance_() noexcept {
+			const State_& state = m_state_;
+			for (;;) {
+				if (m_nNext_ == View::npos) {
+					m_bEnd_ = true;
+					return;
+				}
+
+				const size_t nBegin = m_nNext_;
+				const size_t nSep   = m_nSplits_ < state.nMaxSplits ? state.Find(nBegin) : View::npos;
+				if (nSep == View::npos) {
+					m_svCurrent_ = state.svValue.substr(nBegin);
+					m_nNext_     = View::npos;
+				} else {
+					m_svCurrent_ = state.svValue.substr(nBegin, nSep - nBegin);
+					m_nNext_     = nSep + state.GetSeparatorSize();
+					++m_nSplits_;
+				}
+
+				if (!state.bSkipEmpty || !m_svCurrent_.empty()) {
+					return;
+				}
+				if (nSep != View::npos) {
+					--m_nSplits_; // 被跳过的空片段不计入分割次数
+				}
+			}
+		}
+
+	public:
+		using iterator_concept  = std::forward_iterator_tag;
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = View;
+		using difference_type   = ptrdiff_t;
+		using pointer           = const View*;
+		using reference         = const View&;
+
+		Iterator() = default;
+
+		explicit Iterator(const State_& pc_state) noexcept
+		    : m_state_(pc_state)
+		    , m_nNext_(0)
+		    , m_bEnd_(false) {
+			this->Advance_();
+		}
+
+		const View& operator*() const noexcept {
+			return m_svCurrent_;
+		}
+
+		const View* operator->() const noexcept {
+			return &m_svCurrent_;
+		}
+
+		Iterator& operator++() noexcept {
+			this->Advance_();
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept {
+			Iterator iter = *this;
+			this->Advance_();
+			return iter;
+		}
+
+		friend bool operator==(const Iterator& pc_left, const Iterator& pc_right) noexcept {
+			return pc_left.m_bEnd_ == pc_right.m_bEnd_ && (pc_left.m_bEnd_ || pc_left.m_svCurrent_.data() == pc_right.m_svCurrent_.data());
+		}
+
+		friend bool operator==(const Iterator& pc_iter, std::default_sentinel_t) noexcept {
+			return pc_iter.m_bEnd_;
+		}
+	};
+
+	BasicSplitRange() = default;
+
+	BasicSplitRange(View p_svValue, const _SepT& pc_sep, SplitOptions p_options, size_t p_nMaxSplits) noexcept
+	    : m_state_ { p_svValue, {}, p_nMaxSplits, (static_cast<uint8_t>(p_options) & static_cast<uint8_t>(SplitOptions::SKIP_EMPTY)) != 0 } {
+		if constexpr (IS_CHAR_SET) {
+			m_state_.sep = &pc_sep;
+		} else {
+			m_state_.sep = pc_sep;
+		}
+	}
+
+	Iterator begin() const noexcept {
+		return Iterator(m_state_);
+	}
+
+	std::default_sentinel_t end() const noexcept {
+		return std::default_sentinel;
+	}
 };
 
+using SplitRange      = BasicSplitRange<TCHAR>;
+using SplitAnyOfRange = BasicSplitRange<TCHAR, CharSet>;
+
 _UTILS_END
\ No newline at end of file